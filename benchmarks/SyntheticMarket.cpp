@@ -0,0 +1,105 @@
+#include "SyntheticMarket.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace stds {
+
+namespace {
+
+// 9999-12-31 23:59:59 UTC; later years do not fit the four-digit Date column
+const int64_t kLastWritableTimestamp = 253402300799;
+
+/**
+ * @brief Format seconds since the Unix epoch as "YYYY-MM-DD HH:MM:SS"
+ * @param timestamp Between 0 and kLastWritableTimestamp
+ */
+void formatTimestamp(int64_t timestamp, char* buffer, size_t size) {
+    int64_t days = timestamp / 86400;
+    int64_t seconds = timestamp % 86400;
+    
+    // Civil date from days since 1970-01-01
+    days += 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(days - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    const unsigned day = doy - (153 * mp + 2) / 5 + 1;
+    const unsigned month = mp < 10 ? mp + 3 : mp - 9;
+    const int64_t year = static_cast<int64_t>(yoe) + era * 400 + (month <= 2);
+    
+    // The range checks let the compiler bound every field's width
+    std::snprintf(buffer, size, "%04u-%02u-%02u %02u:%02u:%02u",
+                  static_cast<unsigned>(year) % 10000u, month % 13u, day % 32u,
+                  static_cast<unsigned>(seconds / 3600) % 24u,
+                  static_cast<unsigned>(seconds / 60 % 60),
+                  static_cast<unsigned>(seconds % 60));
+}
+
+}  // namespace
+
+SyntheticMarket::SyntheticMarket(const SyntheticMarketConfig& config)
+    : config_(config),
+      rng_(config.seed),
+      normal_(0.0, 1.0),
+      close_(config.start_price),
+      variance_(config.omega / std::max(1e-6, 1.0 - config.alpha - config.beta)),
+      last_shock_(0.0),
+      timestamp_(config.start_timestamp - config.bar_seconds) {
+}
+
+OHLCV SyntheticMarket::next() {
+    variance_ = config_.omega + config_.alpha * last_shock_ * last_shock_ + config_.beta * variance_;
+    double sigma = std::sqrt(variance_);
+    last_shock_ = sigma * normal_(rng_);
+    
+    OHLCV bar;
+    bar.open = close_;
+    bar.close = close_ * std::exp(config_.drift + last_shock_);
+    bar.high = std::max(bar.open, bar.close) * std::exp(0.5 * sigma * std::fabs(normal_(rng_)));
+    bar.low = std::min(bar.open, bar.close) * std::exp(-0.5 * sigma * std::fabs(normal_(rng_)));
+    bar.volume = std::floor(config_.base_volume * std::exp(0.3 * normal_(rng_)) *
+                            (1.0 + 10.0 * std::fabs(last_shock_)));
+    
+    close_ = bar.close;
+    timestamp_ += config_.bar_seconds;
+    return bar;
+}
+
+std::vector<OHLCV> SyntheticMarket::generate(size_t bars) {
+    std::vector<OHLCV> data;
+    data.reserve(bars);
+    for (size_t i = 0; i < bars; ++i) {
+        data.push_back(next());
+    }
+    return data;
+}
+
+bool SyntheticMarket::writeCSV(const std::string& filename, size_t bars) {
+    // Rows past year 9999 would not parse as dates and would load undated
+    if (timestamp_ < -config_.bar_seconds ||
+        timestamp_ + static_cast<int64_t>(bars) * config_.bar_seconds > kLastWritableTimestamp) {
+        std::fprintf(stderr, "%zu bars of %lld s do not fit between 1970 and 9999\n",
+                     bars, static_cast<long long>(config_.bar_seconds));
+        return false;
+    }
+    
+    FILE* file = std::fopen(filename.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+    
+    std::fputs("Date,Open,High,Low,Close,Volume\n", file);
+    char date[32];
+    for (size_t i = 0; i < bars; ++i) {
+        OHLCV bar = next();
+        formatTimestamp(timestamp_, date, sizeof(date));
+        std::fprintf(file, "%s,%.6f,%.6f,%.6f,%.6f,%.0f\n",
+                     date, bar.open, bar.high, bar.low, bar.close, bar.volume);
+    }
+    
+    return std::fclose(file) == 0;
+}
+
+}  // namespace stds
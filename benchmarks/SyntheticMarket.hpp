@@ -0,0 +1,76 @@
+#ifndef SYNTHETIC_MARKET_HPP
+#define SYNTHETIC_MARKET_HPP
+
+#include "Normalizer.hpp"
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace stds {
+
+/**
+ * @brief Parameters of the synthetic market
+ *
+ * Log-returns follow a GARCH(1,1) process, r_t = drift + sigma_t * z_t with
+ * sigma_t^2 = omega + alpha * (r_{t-1} - drift)^2 + beta * sigma_{t-1}^2,
+ * which reproduces the volatility clustering of real returns.
+ */
+struct SyntheticMarketConfig {
+    uint64_t seed = 42;
+    double start_price = 100.0;
+    double drift = 0.0002;
+    double omega = 4e-6;
+    double alpha = 0.08;
+    double beta = 0.90;
+    double base_volume = 1000000.0;
+    int64_t start_timestamp = 1577836800;  // 2020-01-01 00:00:00 UTC
+    int64_t bar_seconds = 86400;
+};
+
+/**
+ * @brief Seeded generator of OHLCV bars for benchmarks
+ */
+class SyntheticMarket {
+private:
+    SyntheticMarketConfig config_;
+    std::mt19937_64 rng_;
+    std::normal_distribution<double> normal_;
+    double close_;
+    double variance_;
+    double last_shock_;
+    int64_t timestamp_;
+    
+public:
+    /**
+     * @brief Constructor
+     * @param config Process parameters; equal configs produce equal series
+     */
+    explicit SyntheticMarket(const SyntheticMarketConfig& config = SyntheticMarketConfig());
+    
+    /**
+     * @brief Generate the next bar
+     */
+    OHLCV next();
+    
+    /**
+     * @brief Timestamp of the last generated bar
+     */
+    int64_t timestamp() const { return timestamp_; }
+    
+    /**
+     * @brief Generate a series of bars
+     */
+    std::vector<OHLCV> generate(size_t bars);
+    
+    /**
+     * @brief Stream bars to a CSV file in the Date,Open,High,Low,Close,Volume format
+     * @return True if the file was written; false without writing if a date
+     *         would fall outside 1970-9999
+     */
+    bool writeCSV(const std::string& filename, size_t bars);
+};
+
+}  // namespace stds
+
+#endif  // SYNTHETIC_MARKET_HPP
@@ -0,0 +1,255 @@
+#include <benchmark/benchmark.h>
+#include "STDSEngine.hpp"
+#include "SyntheticMarket.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace stds;
+
+namespace {
+
+// Largest series size, set with STDS_BENCH_MAX_BARS (default 1e6, up to 1e8)
+int64_t maxBars() {
+    const char* value = std::getenv("STDS_BENCH_MAX_BARS");
+    int64_t bars = value ? std::atoll(value) : 1000000;
+    return bars < 1000 ? 1000 : bars;
+}
+
+// Register sizes 1e3, 1e4, ... up to maxBars()
+void barSizes(benchmark::internal::Benchmark* bench) {
+    for (int64_t bars = 1000; bars <= maxBars(); bars *= 10) {
+        bench->Arg(bars);
+    }
+}
+
+// Synthetic series of the requested size; only the last size is cached
+const std::vector<OHLCV>& syntheticBars(size_t bars) {
+    static std::vector<OHLCV> cache;
+    if (cache.size() != bars) {
+        cache.clear();
+        cache.shrink_to_fit();
+        SyntheticMarket market;
+        cache = market.generate(bars);
+    }
+    return cache;
+}
+
+// Synthetic CSV files holding bars rows split into files parts. Minute bars keep
+// every size dated: daily bars from 2020 pass year 9999 after about 2.9M rows
+std::vector<std::string> syntheticFiles(size_t bars, size_t files) {
+    std::vector<std::string> paths;
+    SyntheticMarketConfig config;
+    config.bar_seconds = 60;
+    SyntheticMarket market(config);
+    for (size_t f = 0; f < files; ++f) {
+        std::string path = "/tmp/stds_bench_" + std::to_string(bars) + "_" +
+                           std::to_string(f) + ".csv";
+        size_t rows = bars / files + (f < bars % files ? 1 : 0);
+        market.writeCSV(path, rows);
+        paths.push_back(path);
+    }
+    return paths;
+}
+
+void removeFiles(const std::vector<std::string>& paths) {
+    for (const auto& path : paths) {
+        std::remove(path.c_str());
+    }
+}
+
+}  // namespace
+
+// Benchmark CSV ingestion; the second argument is the number of files
+static void BM_LoadData(benchmark::State& state) {
+    std::vector<std::string> paths = syntheticFiles(state.range(0), state.range(1));
+    for (auto _ : state) {
+        STDSEngine engine;
+        benchmark::DoNotOptimize(engine.loadData(paths));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    removeFiles(paths);
+}
+BENCHMARK(BM_LoadData)
+    ->Apply([](benchmark::internal::Benchmark* bench) {
+        for (int64_t bars = 1000; bars <= maxBars() && bars <= 10000000; bars *= 10) {
+            bench->Args({bars, 1});
+            bench->Args({bars, 8});
+        }
+    })
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_NormalizerFit(benchmark::State& state) {
+    const std::vector<OHLCV>& data = syntheticBars(state.range(0));
+    for (auto _ : state) {
+        Normalizer normalizer(10);
+        normalizer.fit(data);
+        benchmark::DoNotOptimize(normalizer.getBinEdges().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_NormalizerFit)->Apply(barSizes)->Unit(benchmark::kMillisecond);
+
+static void BM_NormalizerTransform(benchmark::State& state) {
+    const std::vector<OHLCV>& data = syntheticBars(100000);
+    Normalizer normalizer(static_cast<int>(state.range(0)));
+    normalizer.fit(data);
+    
+    size_t i = 1;
+    for (auto _ : state) {
+        double log_return = Normalizer::calculateLogReturn(data[i - 1].close, data[i].close);
+        benchmark::DoNotOptimize(normalizer.transform(log_return));
+        i = i + 1 < data.size() ? i + 1 : 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NormalizerTransform)->Arg(10)->Arg(16);
+
+static void BM_Symbolize(benchmark::State& state) {
+    STDSEngine engine;
+    engine.setData(syntheticBars(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(engine.symbolize().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Symbolize)->Apply(barSizes)->Unit(benchmark::kMillisecond);
+
+static void BM_Label(benchmark::State& state) {
+    STDSEngine engine;
+    engine.setData(syntheticBars(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(engine.label().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Label)->Apply(barSizes)->Unit(benchmark::kMillisecond);
+
+// Benchmark end-to-end training; the second argument selects the fixed tree
+static void BM_Train(benchmark::State& state) {
+    STDSConfig config;
+    config.use_fixed_tree = state.range(1) != 0;
+    const std::vector<OHLCV>& data = syntheticBars(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        STDSEngine* engine = new STDSEngine(config);
+        engine->setData(data);
+        state.ResumeTiming();
+        
+        engine->train();
+        
+        state.PauseTiming();
+        state.counters["nodes"] = engine->getTree().getNodeCount();
+        delete engine;
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Train)
+    ->Apply([](benchmark::internal::Benchmark* bench) {
+        for (int64_t bars = 1000; bars <= maxBars(); bars *= 10) {
+            bench->Args({bars, 0});
+            bench->Args({bars, 1});
+        }
+    })
+    ->Unit(benchmark::kMillisecond);
+
+// Benchmark 5-fold purged cross-validation; the second argument is the worker count
+static void BM_CrossValidate(benchmark::State& state) {
+    STDSEngine engine;
+    engine.setData(syntheticBars(state.range(0)));
+    CrossValidationOptions options;
+    options.num_threads = static_cast<int>(state.range(1));
+    
+    CrossValidationReport report;
+    for (auto _ : state) {
+        engine.crossValidate(options, report);
+        benchmark::DoNotOptimize(report.accuracy);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CrossValidate)
+    ->Apply([](benchmark::internal::Benchmark* bench) {
+        for (int64_t bars = 1000; bars <= maxBars(); bars *= 10) {
+            bench->Args({bars, 1});
+            bench->Args({bars, 0});
+        }
+    })
+    ->Unit(benchmark::kMillisecond);
+
+// Benchmark tree lookups on a model trained over the given number of bars
+static void BM_Query(benchmark::State& state) {
+    STDSEngine engine;
+    engine.setData(syntheticBars(state.range(0)));
+    engine.train();
+    std::vector<int> symbols = engine.symbolize();
+    const SequenceTree& tree = engine.getTree();
+    
+    size_t i = 0;
+    std::vector<int> sequence(5);
+    for (auto _ : state) {
+        std::copy(symbols.begin() + i, symbols.begin() + i + 5, sequence.begin());
+        benchmark::DoNotOptimize(tree.query(sequence));
+        i = i + 6 < symbols.size() ? i + 1 : 0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Query)->Apply(barSizes);
+
+// Benchmark the per-tick decision path; the second argument selects the fixed tree
+static void BM_ProcessNewData(benchmark::State& state) {
+    STDSConfig config;
+    config.use_fixed_tree = state.range(1) != 0;
+    STDSEngine engine(config);
+    engine.setData(syntheticBars(state.range(0)));
+    engine.train();
+    
+    SyntheticMarketConfig market_config;
+    market_config.seed = 7;
+    SyntheticMarket market(market_config);
+    std::vector<OHLCV> ticks = market.generate(10000);
+    
+    // Each pass over the ticks appends to the history; resetting it after every
+    // pass keeps the history size fixed. One untimed pass first grows the columns
+    // to their final capacity, so reallocation stays out of the timed ticks
+    for (const OHLCV& tick : ticks) {
+        engine.processNewData(tick);
+    }
+    engine.setData(syntheticBars(state.range(0)));
+    
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(engine.processNewData(ticks[i]));
+        if (++i == ticks.size()) {
+            state.PauseTiming();
+            engine.setData(syntheticBars(state.range(0)));
+            i = 0;
+            state.ResumeTiming();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ProcessNewData)
+    ->Apply([](benchmark::internal::Benchmark* bench) {
+        for (int64_t bars = 1000; bars <= maxBars(); bars *= 10) {
+            bench->Args({bars, 0});
+            bench->Args({bars, 1});
+        }
+    });
+
+static void BM_ToJSON(benchmark::State& state) {
+    STDSEngine engine;
+    engine.setData(syntheticBars(state.range(0)));
+    engine.train();
+    
+    size_t bytes = 0;
+    for (auto _ : state) {
+        std::string json = engine.getTreeJSON();
+        bytes = json.size();
+        benchmark::DoNotOptimize(json.data());
+    }
+    state.counters["nodes"] = engine.getTree().getNodeCount();
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_ToJSON)->Apply(barSizes)->Unit(benchmark::kMillisecond);
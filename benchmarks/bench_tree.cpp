@@ -0,0 +1,111 @@
+#include <benchmark/benchmark.h>
+#include "FixedSequenceTree.hpp"
+#include "SequenceTree.hpp"
+#include <vector>
+
+using namespace stds;
+
+// Deterministic pseudo-random sequences skewed towards the middle bins,
+// as quantile symbols of real returns are
+static std::vector<std::vector<int> > makeSequences(int bins, int length, size_t count) {
+    std::vector<std::vector<int> > sequences(count, std::vector<int>(length));
+    unsigned state = 2463534242u;
+    for (auto& sequence : sequences) {
+        for (int& symbol : sequence) {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            int a = state % bins;
+            int b = (state >> 16) % bins;
+            symbol = (a + b) / 2;
+        }
+    }
+    return sequences;
+}
+
+// Benchmark dynamic SequenceTree lookups for a (bins, length) shape
+template <int Bins, int Depth>
+static void BM_DynamicTreeQuery(benchmark::State& state) {
+    std::vector<std::vector<int> > sequences = makeSequences(Bins, Depth, 100000);
+    SequenceTree tree(0.70);
+    for (const auto& sequence : sequences) {
+        tree.insertSequence(sequence, sequence[0] % 2 == 0, sequence[0] % 3 == 0);
+    }
+    
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(tree.findNode(sequences[i]));
+        i = (i + 7919) % sequences.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_DynamicTreeQuery, 10, 5);
+BENCHMARK_TEMPLATE(BM_DynamicTreeQuery, 16, 8);
+
+// Benchmark FixedSequenceTree lookups for the same shapes
+template <int Bins, int Depth>
+static void BM_FixedTreeQuery(benchmark::State& state) {
+    std::vector<std::vector<int> > sequences = makeSequences(Bins, Depth, 100000);
+    FixedSequenceTree<Bins, Depth> tree(0.70);
+    for (const auto& sequence : sequences) {
+        tree.insertSequence(sequence.data(), sequence[0] % 2 == 0, sequence[0] % 3 == 0);
+    }
+    
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(tree.query(sequences[i].data()));
+        i = (i + 7919) % sequences.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_FixedTreeQuery, 10, 5);
+BENCHMARK_TEMPLATE(BM_FixedTreeQuery, 16, 8);
+
+// Benchmark building a dynamic tree from scratch
+template <int Bins, int Depth>
+static void BM_DynamicTreeInsert(benchmark::State& state) {
+    std::vector<std::vector<int> > sequences = makeSequences(Bins, Depth, 100000);
+    for (auto _ : state) {
+        SequenceTree tree(0.70);
+        for (const auto& sequence : sequences) {
+            tree.insertSequence(sequence, sequence[0] % 2 == 0, sequence[0] % 3 == 0);
+        }
+        benchmark::DoNotOptimize(tree.getNodeCount());
+    }
+    state.SetItemsProcessed(state.iterations() * sequences.size());
+}
+BENCHMARK_TEMPLATE(BM_DynamicTreeInsert, 10, 5)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_DynamicTreeInsert, 16, 8)->Unit(benchmark::kMillisecond);
+
+// Benchmark building a fixed tree from scratch
+template <int Bins, int Depth>
+static void BM_FixedTreeInsert(benchmark::State& state) {
+    std::vector<std::vector<int> > sequences = makeSequences(Bins, Depth, 100000);
+    for (auto _ : state) {
+        FixedSequenceTree<Bins, Depth> tree(0.70);
+        for (const auto& sequence : sequences) {
+            tree.insertSequence(sequence.data(), sequence[0] % 2 == 0, sequence[0] % 3 == 0);
+        }
+        benchmark::DoNotOptimize(tree.getNodeCount());
+    }
+    state.SetItemsProcessed(state.iterations() * sequences.size());
+}
+BENCHMARK_TEMPLATE(BM_FixedTreeInsert, 10, 5)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_FixedTreeInsert, 16, 8)->Unit(benchmark::kMillisecond);
+
+// Benchmark reading the top K patterns from an incrementally maintained index
+static void BM_PatternIndexTop(benchmark::State& state) {
+    std::vector<std::vector<int> > sequences = makeSequences(10, 5, 100000);
+    SequenceTree tree(0.70);
+    PatternIndex index(PatternScore::WILSON);
+    tree.setPatternIndex(&index);
+    for (const auto& sequence : sequences) {
+        tree.insertSequence(sequence, sequence[0] % 2 == 0, sequence[0] % 3 == 0);
+    }
+    
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(index.top(static_cast<size_t>(state.range(0))));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PatternIndexTop)->Arg(10)->Arg(100);
@@ -0,0 +1,192 @@
+#include "DataLoader.hpp"
+#include "STDSEngine.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace stds;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * @brief Command-line options of the replay tool
+ */
+struct ReplayOptions {
+    std::string train_path;
+    std::string replay_path;
+    std::string decisions_path;
+    double speed = 0.0;          // Multiple of real time; 0 = as fast as possible
+    double interval_ms = 1000.0; // Bar spacing used when the replay file is undated
+    STDSConfig config;
+};
+
+void printUsage() {
+    std::cerr
+        << "Usage: stds_replay --train <csv|dir> --replay <csv> [options]\n"
+        << "  --speed <N|max>          Replay at N x real time (default: max)\n"
+        << "  --interval-ms <ms>       Bar spacing for undated replay files (default: 1000)\n"
+        << "  --decisions <file>       Write the decision stream as CSV for diffing\n"
+        << "  --bins <n> --length <n> --threshold <x> --lookahead <n> --take-profit <x>\n"
+        << "  --approximate <d> --rolling <n> --fixed-tree\n";
+}
+
+bool parseArgs(int argc, char** argv, ReplayOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        std::string value = has_value ? argv[i + 1] : "";
+        
+        if (arg == "--fixed-tree") {
+            options.config.use_fixed_tree = true;
+            continue;
+        }
+        if (!has_value) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        ++i;
+        
+        if (arg == "--train") {
+            options.train_path = value;
+        } else if (arg == "--replay") {
+            options.replay_path = value;
+        } else if (arg == "--decisions") {
+            options.decisions_path = value;
+        } else if (arg == "--speed") {
+            options.speed = (value == "max") ? 0.0 : std::atof(value.c_str());
+        } else if (arg == "--interval-ms") {
+            options.interval_ms = std::atof(value.c_str());
+        } else if (arg == "--bins") {
+            options.config.num_bins = std::atoi(value.c_str());
+        } else if (arg == "--length") {
+            options.config.sequence_length = std::atoi(value.c_str());
+        } else if (arg == "--threshold") {
+            options.config.confidence_threshold = std::atof(value.c_str());
+        } else if (arg == "--lookahead") {
+            options.config.lookahead_days = std::atoi(value.c_str());
+        } else if (arg == "--take-profit") {
+            options.config.take_profit_threshold = std::atof(value.c_str());
+        } else if (arg == "--approximate") {
+            options.config.approximate_max_distance = std::atoi(value.c_str());
+        } else if (arg == "--rolling") {
+            options.config.rolling_window = std::atoi(value.c_str());
+        } else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return false;
+        }
+    }
+    
+    return !options.train_path.empty() && !options.replay_path.empty();
+}
+
+uint64_t percentile(const std::vector<uint64_t>& sorted, double q) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t rank = static_cast<size_t>(q * sorted.size() + 0.5);
+    rank = std::min(std::max(rank, static_cast<size_t>(1)), sorted.size());
+    return sorted[rank - 1];
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    ReplayOptions options;
+    if (!parseArgs(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+    
+    STDSEngine engine(options.config);
+    if (!engine.loadData(options.train_path)) {
+        std::cerr << "Failed to load training data" << std::endl;
+        return 1;
+    }
+    engine.train();
+    
+    std::vector<OHLCV> ticks;
+    std::vector<int64_t> timestamps;
+    LoadReport report;
+    DataLoader loader(1, options.config.max_gap_ratio);
+    if (!loader.load(std::vector<std::string>(1, options.replay_path), ticks, timestamps, report)) {
+        std::cerr << "Failed to load replay data" << std::endl;
+        return 1;
+    }
+    bool dated = report.undated_rows == 0;
+    
+    // Arrival offset of every tick relative to the first, in nanoseconds of wall time
+    std::vector<int64_t> arrivals(ticks.size(), 0);
+    if (options.speed > 0.0) {
+        for (size_t i = 0; i < ticks.size(); ++i) {
+            double seconds = dated ? static_cast<double>(timestamps[i] - timestamps[0])
+                                   : i * options.interval_ms / 1000.0;
+            arrivals[i] = static_cast<int64_t>(seconds * 1e9 / options.speed);
+        }
+    }
+    
+    std::vector<std::string> decisions(ticks.size());
+    std::vector<uint64_t> latencies(ticks.size());
+    
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < ticks.size(); ++i) {
+        // Latency runs from the scheduled arrival, so falling behind shows up as queueing
+        Clock::time_point scheduled = start + std::chrono::nanoseconds(arrivals[i]);
+        if (options.speed > 0.0) {
+            // Sleep most of the wait, then spin so oversleeping does not count as latency
+            std::this_thread::sleep_until(scheduled - std::chrono::microseconds(200));
+            while (Clock::now() < scheduled) {
+            }
+        } else {
+            scheduled = Clock::now();
+        }
+        
+        decisions[i] = engine.processNewData(ticks[i]);
+        
+        latencies[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now() - scheduled).count();
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    
+    if (!options.decisions_path.empty()) {
+        std::ofstream out(options.decisions_path.c_str());
+        out << "index,timestamp,close,decision\n";
+        for (size_t i = 0; i < ticks.size(); ++i) {
+            out << i << "," << (timestamps[i] == kNoTimestamp ? 0 : timestamps[i]) << ","
+                << ticks[i].close << "," << decisions[i] << "\n";
+        }
+    }
+    
+    size_t counts[4] = {0, 0, 0, 0};
+    for (const auto& decision : decisions) {
+        counts[decision == "BUY" ? 0 : decision == "SELL" ? 1 : decision == "HOLD" ? 2 : 3]++;
+    }
+    
+    std::vector<uint64_t> sorted(latencies);
+    std::sort(sorted.begin(), sorted.end());
+    
+    std::printf("{\"mode\":\"native\",\"ticks\":%zu,\"speed\":%s,\"elapsed_s\":%.6f,"
+                "\"throughput_per_s\":%.1f,\"latency_ns\":{\"p50\":%llu,\"p99\":%llu,"
+                "\"p999\":%llu,\"max\":%llu},\"decisions\":{\"BUY\":%zu,\"SELL\":%zu,"
+                "\"HOLD\":%zu,\"NONE\":%zu},\"fixed_tree\":%s}\n",
+                ticks.size(),
+                options.speed > 0.0 ? std::to_string(options.speed).c_str() : "\"max\"",
+                elapsed,
+                elapsed > 0.0 ? ticks.size() / elapsed : 0.0,
+                static_cast<unsigned long long>(percentile(sorted, 0.50)),
+                static_cast<unsigned long long>(percentile(sorted, 0.99)),
+                static_cast<unsigned long long>(percentile(sorted, 0.999)),
+                static_cast<unsigned long long>(sorted.empty() ? 0 : sorted.back()),
+                counts[0], counts[1], counts[2], counts[3],
+                engine.usesFixedTree() ? "true" : "false");
+    
+    return 0;
+}
@@ -1,23 +1,88 @@
 #include <napi.h>
 #include "STDSEngine.hpp"
+#include "SpscRing.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Tick queued by the JS thread for the native engine thread
+struct TickEvent {
+    stds::OHLCV data;
+    uint64_t seq;
+    std::chrono::steady_clock::time_point enqueued;
+};
+
+// Decision produced by the engine thread, delivered to JS in batches
+struct DecisionEvent {
+    uint64_t seq;
+    const char* decision;
+    uint64_t latency_ns;  // Enqueue to decision
+};
+
+// Copy of a node taken on the engine side; the node itself may be gone by
+// the time the JS callback runs
+struct NodeEvent {
+    uint32_t id;
+    int symbol;
+    uint64_t weight;
+    std::string synthesis;
+    stds::Stats stats;
+};
 
 class STDSEngineWrapper : public Napi::ObjectWrap<STDSEngineWrapper> {
 public:
     static Napi::Object Init(Napi::Env env, Napi::Object exports);
     STDSEngineWrapper(const Napi::CallbackInfo& info);
+    ~STDSEngineWrapper();
 
 private:
     static Napi::FunctionReference constructor;
     std::unique_ptr<stds::STDSEngine> engine_;
     Napi::ThreadSafeFunction tsfn_;
 
+    // Guards engine_ between JS calls and the engine thread
+    std::mutex engine_mutex_;
+
+    // Native engine thread fed by a lock-free tick ring
+    std::unique_ptr<stds::SpscRing<TickEvent> > tick_ring_;
+    std::thread engine_thread_;
+    std::atomic<bool> engine_thread_running_;
+    std::atomic<bool> engine_thread_parked_;
+    std::mutex park_mutex_;
+    std::condition_variable park_cv_;
+    Napi::ThreadSafeFunction decision_tsfn_;
+    uint64_t next_tick_seq_;
+    size_t max_batch_;
+
+    void EngineThreadLoop();
+    void StopEngineThread();
+    static void DeliverDecisions(Napi::Env env, Napi::Function jsCallback,
+                                 std::vector<DecisionEvent>* batch);
+
     Napi::Value LoadData(const Napi::CallbackInfo& info);
+    Napi::Value GetLoadReport(const Napi::CallbackInfo& info);
     Napi::Value Train(const Napi::CallbackInfo& info);
+    Napi::Value CrossValidate(const Napi::CallbackInfo& info);
     Napi::Value ProcessNewData(const Napi::CallbackInfo& info);
     Napi::Value GetTreeJSON(const Napi::CallbackInfo& info);
+    Napi::Value GetTreeVersion(const Napi::CallbackInfo& info);
+    Napi::Value GetTreeEpoch(const Napi::CallbackInfo& info);
+    Napi::Value GetTreeStats(const Napi::CallbackInfo& info);
+    Napi::Value GetTopPatterns(const Napi::CallbackInfo& info);
+    Napi::Value GetTreeDelta(const Napi::CallbackInfo& info);
     Napi::Value SetNodeCallback(const Napi::CallbackInfo& info);
+    Napi::Value GetMetrics(const Napi::CallbackInfo& info);
+    Napi::Value SetMetricsEnabled(const Napi::CallbackInfo& info);
+    Napi::Value StartEngineThread(const Napi::CallbackInfo& info);
+    Napi::Value EnqueueTick(const Napi::CallbackInfo& info);
+    Napi::Value StopEngineThreadJS(const Napi::CallbackInfo& info);
 };
 
 Napi::FunctionReference STDSEngineWrapper::constructor;
@@ -27,10 +92,22 @@ Napi::Object STDSEngineWrapper::Init(Napi::Env env, Napi::Object exports) {
 
     Napi::Function func = DefineClass(env, "STDSEngine", {
         InstanceMethod("loadData", &STDSEngineWrapper::LoadData),
+        InstanceMethod("getLoadReport", &STDSEngineWrapper::GetLoadReport),
         InstanceMethod("train", &STDSEngineWrapper::Train),
+        InstanceMethod("crossValidate", &STDSEngineWrapper::CrossValidate),
         InstanceMethod("processNewData", &STDSEngineWrapper::ProcessNewData),
         InstanceMethod("getTreeJSON", &STDSEngineWrapper::GetTreeJSON),
-        InstanceMethod("setNodeCallback", &STDSEngineWrapper::SetNodeCallback)
+        InstanceMethod("getTreeVersion", &STDSEngineWrapper::GetTreeVersion),
+        InstanceMethod("getTreeEpoch", &STDSEngineWrapper::GetTreeEpoch),
+        InstanceMethod("getTreeStats", &STDSEngineWrapper::GetTreeStats),
+        InstanceMethod("getTopPatterns", &STDSEngineWrapper::GetTopPatterns),
+        InstanceMethod("getTreeDelta", &STDSEngineWrapper::GetTreeDelta),
+        InstanceMethod("setNodeCallback", &STDSEngineWrapper::SetNodeCallback),
+        InstanceMethod("getMetrics", &STDSEngineWrapper::GetMetrics),
+        InstanceMethod("setMetricsEnabled", &STDSEngineWrapper::SetMetricsEnabled),
+        InstanceMethod("startEngineThread", &STDSEngineWrapper::StartEngineThread),
+        InstanceMethod("enqueueTick", &STDSEngineWrapper::EnqueueTick),
+        InstanceMethod("stopEngineThread", &STDSEngineWrapper::StopEngineThreadJS)
     });
 
     constructor = Napi::Persistent(func);
@@ -41,7 +118,11 @@ Napi::Object STDSEngineWrapper::Init(Napi::Env env, Napi::Object exports) {
 }
 
 STDSEngineWrapper::STDSEngineWrapper(const Napi::CallbackInfo& info)
-    : Napi::ObjectWrap<STDSEngineWrapper>(info) {
+    : Napi::ObjectWrap<STDSEngineWrapper>(info),
+      engine_thread_running_(false),
+      engine_thread_parked_(false),
+      next_tick_seq_(0),
+      max_batch_(256) {
     Napi::Env env = info.Env();
     Napi::HandleScope scope(env);
 
@@ -66,13 +147,75 @@ STDSEngineWrapper::STDSEngineWrapper(const Napi::CallbackInfo& info)
         if (configObj.Has("takeProfitThreshold")) {
             config.take_profit_threshold = configObj.Get("takeProfitThreshold").As<Napi::Number>().DoubleValue();
         }
+        if (configObj.Has("approximateMaxDistance")) {
+            config.approximate_max_distance = configObj.Get("approximateMaxDistance").As<Napi::Number>().Int32Value();
+        }
+        if (configObj.Has("approximateMetric")) {
+            std::string metric = configObj.Get("approximateMetric").As<Napi::String>().Utf8Value();
+            config.approximate_metric = (metric == "HAMMING") ? stds::DistanceMetric::HAMMING
+                                                              : stds::DistanceMetric::L1;
+        }
+        if (configObj.Has("approximateTimeBudgetUs")) {
+            config.approximate_time_budget_us = configObj.Get("approximateTimeBudgetUs").As<Napi::Number>().Int64Value();
+        }
+        if (configObj.Has("useFixedTree")) {
+            config.use_fixed_tree = configObj.Get("useFixedTree").As<Napi::Boolean>().Value();
+        }
+        if (configObj.Has("rollingWindow")) {
+            config.rolling_window = configObj.Get("rollingWindow").As<Napi::Number>().Int32Value();
+        }
+        if (configObj.Has("enableMetrics")) {
+            config.enable_metrics = configObj.Get("enableMetrics").As<Napi::Boolean>().Value();
+        }
+        if (configObj.Has("loadThreads")) {
+            config.load_threads = configObj.Get("loadThreads").As<Napi::Number>().Int32Value();
+        }
+        if (configObj.Has("maxGapRatio")) {
+            config.max_gap_ratio = configObj.Get("maxGapRatio").As<Napi::Number>().DoubleValue();
+        }
+        if (configObj.Has("enablePatternIndex")) {
+            config.enable_pattern_index = configObj.Get("enablePatternIndex").As<Napi::Boolean>().Value();
+        }
+        if (configObj.Has("enableDeltaFeed")) {
+            config.enable_delta_feed = configObj.Get("enableDeltaFeed").As<Napi::Boolean>().Value();
+        }
+        if (configObj.Has("patternScore")) {
+            std::string score = configObj.Get("patternScore").As<Napi::String>().Utf8Value();
+            config.pattern_score = (score == "SUPPORT") ? stds::PatternScore::SUPPORT
+                                 : (score == "WIN_RATIO") ? stds::PatternScore::WIN_RATIO
+                                 : stds::PatternScore::WILSON;
+        }
+        if (configObj.Has("historyPrecision")) {
+            std::string precision = configObj.Get("historyPrecision").As<Napi::String>().Utf8Value();
+            config.history_precision = (precision == "FLOAT32") ? stds::ColumnPrecision::FLOAT32
+                                                                : stds::ColumnPrecision::FLOAT64;
+        }
     }
 
     engine_.reset(new stds::STDSEngine(config));
 }
 
+STDSEngineWrapper::~STDSEngineWrapper() {
+    StopEngineThread();
+}
+
 Napi::Value STDSEngineWrapper::LoadData(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
+    std::lock_guard<std::mutex> lock(engine_mutex_);
+
+    if (info.Length() > 0 && info[0].IsArray()) {
+        Napi::Array array = info[0].As<Napi::Array>();
+        std::vector<std::string> filenames;
+        for (uint32_t i = 0; i < array.Length(); ++i) {
+            Napi::Value value = array.Get(i);
+            if (!value.IsString()) {
+                Napi::TypeError::New(env, "Array of strings expected").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            filenames.push_back(value.As<Napi::String>().Utf8Value());
+        }
+        return Napi::Boolean::New(env, engine_->loadData(filenames));
+    }
 
     if (info.Length() < 1 || !info[0].IsString()) {
         Napi::TypeError::New(env, "String expected").ThrowAsJavaScriptException();
@@ -85,8 +228,27 @@ Napi::Value STDSEngineWrapper::LoadData(const Napi::CallbackInfo& info) {
     return Napi::Boolean::New(env, success);
 }
 
+Napi::Value STDSEngineWrapper::GetLoadReport(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    std::lock_guard<std::mutex> lock(engine_mutex_);
+
+    const stds::LoadReport& report = engine_->getLoadReport();
+    Napi::Object reportObj = Napi::Object::New(env);
+    reportObj.Set("files", Napi::Number::New(env, report.files));
+    reportObj.Set("failedFiles", Napi::Number::New(env, report.failed_files));
+    reportObj.Set("rows", Napi::Number::New(env, report.rows));
+    reportObj.Set("malformedRows", Napi::Number::New(env, report.malformed_rows));
+    reportObj.Set("undatedRows", Napi::Number::New(env, report.undated_rows));
+    reportObj.Set("duplicates", Napi::Number::New(env, report.duplicates));
+    reportObj.Set("gaps", Napi::Number::New(env, report.gaps));
+
+    return reportObj;
+}
+
+// Training rebuilds the tree the engine thread reads, so ticks wait until it ends
 Napi::Value STDSEngineWrapper::Train(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
+    std::lock_guard<std::mutex> lock(engine_mutex_);
     
     engine_->train();
     
@@ -95,6 +257,7 @@ Napi::Value STDSEngineWrapper::Train(const Napi::CallbackInfo& info) {
 
 Napi::Value STDSEngineWrapper::ProcessNewData(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
+    std::lock_guard<std::mutex> lock(engine_mutex_);
 
     if (info.Length() < 1 || !info[0].IsObject()) {
         Napi::TypeError::New(env, "Object expected").ThrowAsJavaScriptException();
@@ -115,16 +278,205 @@ Napi::Value STDSEngineWrapper::ProcessNewData(const Napi::CallbackInfo& info) {
     return Napi::String::New(env, decision);
 }
 
+// Serializing walks the live tree, so ticks wait until it ends; prefer getTreeDelta
 Napi::Value STDSEngineWrapper::GetTreeJSON(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
+    std::lock_guard<std::mutex> lock(engine_mutex_);
     
     std::string json = engine_->getTreeJSON();
     
     return Napi::String::New(env, json);
 }
 
+Napi::Value STDSEngineWrapper::GetTreeVersion(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    std::lock_guard<std::mutex> lock(engine_mutex_);
+    
+    return Napi::Number::New(env, static_cast<double>(engine_->getTreeVersion()));
+}
+
+Napi::Value STDSEngineWrapper::GetTreeEpoch(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    std::lock_guard<std::mutex> lock(engine_mutex_);
+    
+    return Napi::Number::New(env, static_cast<double>(engine_->getTreeEpoch()));
+}
+
+static Napi::Array ToNumberArray(Napi::Env env, const std::vector<uint64_t>& values) {
+    Napi::Array array = Napi::Array::New(env, values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        array.Set(static_cast<uint32_t>(i), Napi::Number::New(env, static_cast<double>(values[i])));
+    }
+    return array;
+}
+
+Napi::Value STDSEngineWrapper::GetTreeStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    std::lock_guard<std::mutex> lock(engine_mutex_);
+    
+    stds::TreeStats stats = engine_->getTreeStats();
+    
+    Napi::Object statsObj = Napi::Object::New(env);
+    statsObj.Set("nodes", Napi::Number::New(env, stats.nodes));
+    statsObj.Set("leaves", Napi::Number::New(env, stats.leaves));
+    statsObj.Set("maxDepth", Napi::Number::New(env, stats.max_depth));
+    
+    Napi::Object bytesObj = Napi::Object::New(env);
+    bytesObj.Set("nodes", Napi::Number::New(env, stats.node_bytes));
+    bytesObj.Set("childMaps", Napi::Number::New(env, stats.child_map_bytes));
+    bytesObj.Set("index", Napi::Number::New(env, stats.index_bytes));
+    bytesObj.Set("journal", Napi::Number::New(env, stats.journal_bytes));
+    bytesObj.Set("total", Napi::Number::New(env, stats.total_bytes));
+    bytesObj.Set("peakTracked", Napi::Number::New(env, stats.peak_tracked_bytes));
+    statsObj.Set("bytes", bytesObj);
+    
+    statsObj.Set("nodesPerDepth", ToNumberArray(env, stats.nodes_per_depth));
+    statsObj.Set("branching", ToNumberArray(env, stats.branching));
+    statsObj.Set("supportHistogram", ToNumberArray(env, stats.support_histogram));
+    
+    Napi::Object decisionsObj = Napi::Object::New(env);
+    decisionsObj.Set("BUY", Napi::Number::New(env, stats.buy_nodes));
+    decisionsObj.Set("SELL", Napi::Number::New(env, stats.sell_nodes));
+    decisionsObj.Set("HOLD", Napi::Number::New(env, stats.hold_nodes));
+    decisionsObj.Set("NONE", Napi::Number::New(env, stats.none_nodes));
+    statsObj.Set("decisions", decisionsObj);
+    
+    return statsObj;
+}
+
+Napi::Value STDSEngineWrapper::CrossValidate(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    stds::CrossValidationOptions options;
+    if (info.Length() > 0 && info[0].IsObject()) {
+        Napi::Object optionsObj = info[0].As<Napi::Object>();
+        if (optionsObj.Has("folds")) {
+            options.folds = optionsObj.Get("folds").As<Napi::Number>().Int32Value();
+        }
+        if (optionsObj.Has("embargo")) {
+            options.embargo = optionsObj.Get("embargo").As<Napi::Number>().Int32Value();
+        }
+        if (optionsObj.Has("threads")) {
+            options.num_threads = optionsObj.Get("threads").As<Napi::Number>().Int32Value();
+        }
+    }
+    
+    // Copy the inputs under the lock, then run the folds without it so the
+    // engine thread keeps answering ticks
+    std::vector<int> symbols;
+    std::vector<uint8_t> labels;
+    std::unique_ptr<stds::CrossValidator> validator;
+    {
+        std::lock_guard<std::mutex> lock(engine_mutex_);
+        symbols = engine_->symbolize();
+        labels = engine_->label();
+        validator.reset(new stds::CrossValidator(engine_->makeCrossValidator()));
+    }
+    
+    stds::CrossValidationReport report;
+    if (!validator->run(symbols, labels, options, report)) {
+        Napi::Error::New(env, "Not enough data for cross-validation").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+    
+    Napi::Array foldsArray = Napi::Array::New(env, report.folds.size());
+    for (size_t i = 0; i < report.folds.size(); ++i) {
+        const stds::FoldResult& fold = report.folds[i];
+        Napi::Object foldObj = Napi::Object::New(env);
+        foldObj.Set("testBegin", Napi::Number::New(env, fold.test_begin));
+        foldObj.Set("testEnd", Napi::Number::New(env, fold.test_end));
+        foldObj.Set("trainWindows", Napi::Number::New(env, fold.train_windows));
+        foldObj.Set("purgedWindows", Napi::Number::New(env, fold.purged_windows));
+        foldObj.Set("testWindows", Napi::Number::New(env, fold.test_windows));
+        foldObj.Set("buyTrades", Napi::Number::New(env, fold.buy_trades));
+        foldObj.Set("sellTrades", Napi::Number::New(env, fold.sell_trades));
+        foldObj.Set("correct", Napi::Number::New(env, fold.correct));
+        foldObj.Set("accuracy", Napi::Number::New(env, fold.accuracy));
+        foldObj.Set("coverage", Napi::Number::New(env, fold.coverage));
+        foldsArray.Set(static_cast<uint32_t>(i), foldObj);
+    }
+    
+    Napi::Object reportObj = Napi::Object::New(env);
+    reportObj.Set("folds", foldsArray);
+    reportObj.Set("testWindows", Napi::Number::New(env, report.test_windows));
+    reportObj.Set("trades", Napi::Number::New(env, report.trades));
+    reportObj.Set("correct", Napi::Number::New(env, report.correct));
+    reportObj.Set("accuracy", Napi::Number::New(env, report.accuracy));
+    reportObj.Set("coverage", Napi::Number::New(env, report.coverage));
+    reportObj.Set("elapsedUs", Napi::Number::New(env, static_cast<double>(report.elapsed_us)));
+    reportObj.Set("rollingWindowIgnored", Napi::Boolean::New(env, report.rolling_window_ignored));
+    reportObj.Set("fixedTree", Napi::Boolean::New(env, report.fixed_tree));
+    
+    return reportObj;
+}
+
+Napi::Value STDSEngineWrapper::GetTopPatterns(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    std::lock_guard<std::mutex> lock(engine_mutex_);
+    
+    size_t k = 10;
+    if (info.Length() > 0 && info[0].IsNumber()) {
+        int64_t value = info[0].As<Napi::Number>().Int64Value();
+        k = value > 0 ? static_cast<size_t>(value) : 0;
+    }
+    stds::PatternSide side = stds::PatternSide::BOTH;
+    if (info.Length() > 1 && info[1].IsString()) {
+        std::string name = info[1].As<Napi::String>().Utf8Value();
+        if (name == "BUY") {
+            side = stds::PatternSide::BUY;
+        } else if (name == "SELL") {
+            side = stds::PatternSide::SELL;
+        }
+    }
+    
+    std::vector<stds::RankedPattern> patterns = engine_->getTopPatterns(k, side);
+    
+    Napi::Array result = Napi::Array::New(env, patterns.size());
+    for (size_t i = 0; i < patterns.size(); ++i) {
+        const stds::RankedPattern& pattern = patterns[i];
+        
+        Napi::Array sequence = Napi::Array::New(env, pattern.sequence.size());
+        for (size_t j = 0; j < pattern.sequence.size(); ++j) {
+            sequence.Set(static_cast<uint32_t>(j), Napi::Number::New(env, pattern.sequence[j]));
+        }
+        
+        Napi::Object patternObj = Napi::Object::New(env);
+        patternObj.Set("sequence", sequence);
+        patternObj.Set("id", Napi::Number::New(env, pattern.node_id));
+        patternObj.Set("decision", Napi::String::New(env, pattern.is_buy ? "BUY" : "SELL"));
+        patternObj.Set("weight", Napi::Number::New(env, pattern.weight));
+        patternObj.Set("score", Napi::Number::New(env, pattern.score));
+        
+        Napi::Object statsObj = Napi::Object::New(env);
+        statsObj.Set("buyWins", Napi::Number::New(env, pattern.stats.buy_wins));
+        statsObj.Set("sellWins", Napi::Number::New(env, pattern.stats.sell_wins));
+        statsObj.Set("holdCount", Napi::Number::New(env, pattern.stats.hold_count));
+        patternObj.Set("stats", statsObj);
+        
+        result.Set(static_cast<uint32_t>(i), patternObj);
+    }
+    
+    return result;
+}
+
+Napi::Value STDSEngineWrapper::GetTreeDelta(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    std::lock_guard<std::mutex> lock(engine_mutex_);
+    
+    uint64_t since = 0;
+    if (info.Length() > 0 && info[0].IsNumber()) {
+        double value = info[0].As<Napi::Number>().DoubleValue();
+        since = value > 0 ? static_cast<uint64_t>(value) : 0;
+    }
+    
+    std::string json = engine_->getTreeDelta(since);
+    
+    return Napi::String::New(env, json);
+}
+
 Napi::Value STDSEngineWrapper::SetNodeCallback(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
+    std::lock_guard<std::mutex> lock(engine_mutex_);
 
     if (info.Length() < 1 || !info[0].IsFunction()) {
         Napi::TypeError::New(env, "Function expected").ThrowAsJavaScriptException();
@@ -144,17 +496,18 @@ Napi::Value STDSEngineWrapper::SetNodeCallback(const Napi::CallbackInfo& info) {
 
     // Set callback in C++ engine
     engine_->setNodeCallback([this](const stds::SequenceNode* node) {
-        auto callback = [node](Napi::Env env, Napi::Function jsCallback) {
+        NodeEvent event = { node->id, node->symbol, node->weight, node->synthesis, node->stats };
+        auto callback = [event](Napi::Env env, Napi::Function jsCallback) {
             Napi::Object nodeObj = Napi::Object::New(env);
-            nodeObj.Set("id", Napi::Number::New(env, node->id));
-            nodeObj.Set("symbol", Napi::Number::New(env, node->symbol));
-            nodeObj.Set("weight", Napi::Number::New(env, node->weight));
-            nodeObj.Set("synthesis", Napi::String::New(env, node->synthesis));
+            nodeObj.Set("id", Napi::Number::New(env, event.id));
+            nodeObj.Set("symbol", Napi::Number::New(env, event.symbol));
+            nodeObj.Set("weight", Napi::Number::New(env, event.weight));
+            nodeObj.Set("synthesis", Napi::String::New(env, event.synthesis));
             
             Napi::Object statsObj = Napi::Object::New(env);
-            statsObj.Set("buyWins", Napi::Number::New(env, node->stats.buy_wins));
-            statsObj.Set("sellWins", Napi::Number::New(env, node->stats.sell_wins));
-            statsObj.Set("holdCount", Napi::Number::New(env, node->stats.hold_count));
+            statsObj.Set("buyWins", Napi::Number::New(env, event.stats.buy_wins));
+            statsObj.Set("sellWins", Napi::Number::New(env, event.stats.sell_wins));
+            statsObj.Set("holdCount", Napi::Number::New(env, event.stats.hold_count));
             nodeObj.Set("stats", statsObj);
             
             jsCallback.Call({nodeObj});
@@ -166,6 +519,235 @@ Napi::Value STDSEngineWrapper::SetNodeCallback(const Napi::CallbackInfo& info) {
     return env.Undefined();
 }
 
+Napi::Value STDSEngineWrapper::GetMetrics(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    std::lock_guard<std::mutex> lock(engine_mutex_);
+
+    static const char* const stageNames[] = {
+        "parse", "fit", "symbolize", "label", "insert", "tick"
+    };
+    static const char* const counterNames[] = {
+        "rowsLoaded", "windowsInserted", "windowsExpired", "ticks",
+        "approximateQueries", "approximateTimeouts", "syntheses"
+    };
+
+    stds::MetricsSnapshot metrics = engine_->getMetrics();
+    Napi::Object metricsObj = Napi::Object::New(env);
+    metricsObj.Set("compiledIn", Napi::Boolean::New(env, metrics.compiled_in));
+    metricsObj.Set("enabled", Napi::Boolean::New(env, metrics.enabled));
+
+    Napi::Object stagesObj = Napi::Object::New(env);
+    for (int i = 0; i < static_cast<int>(stds::Stage::COUNT); ++i) {
+        Napi::Object stageObj = Napi::Object::New(env);
+        stageObj.Set("calls", Napi::Number::New(env, metrics.stages[i].calls));
+        stageObj.Set("totalNs", Napi::Number::New(env, metrics.stages[i].total_ns));
+        stageObj.Set("maxNs", Napi::Number::New(env, metrics.stages[i].max_ns));
+        stagesObj.Set(stageNames[i], stageObj);
+    }
+    metricsObj.Set("stages", stagesObj);
+
+    Napi::Object countersObj = Napi::Object::New(env);
+    for (int i = 0; i < static_cast<int>(stds::Counter::COUNT); ++i) {
+        countersObj.Set(counterNames[i], Napi::Number::New(env, metrics.counters[i]));
+    }
+    metricsObj.Set("counters", countersObj);
+
+    Napi::Object tickObj = Napi::Object::New(env);
+    tickObj.Set("count", Napi::Number::New(env, metrics.tick_count));
+    tickObj.Set("p50Ns", Napi::Number::New(env, metrics.tick_p50_ns));
+    tickObj.Set("p99Ns", Napi::Number::New(env, metrics.tick_p99_ns));
+    tickObj.Set("p999Ns", Napi::Number::New(env, metrics.tick_p999_ns));
+    metricsObj.Set("tickLatency", tickObj);
+
+    Napi::Object treeObj = Napi::Object::New(env);
+    treeObj.Set("nodes", Napi::Number::New(env, metrics.tree_nodes));
+    treeObj.Set("bytes", Napi::Number::New(env, metrics.tree_bytes));
+    treeObj.Set("allocations", Napi::Number::New(env, metrics.node_allocations));
+    metricsObj.Set("tree", treeObj);
+
+    Napi::Object historyObj = Napi::Object::New(env);
+    historyObj.Set("bars", Napi::Number::New(env, metrics.history_bars));
+    historyObj.Set("bytes", Napi::Number::New(env, metrics.history_bytes));
+    metricsObj.Set("history", historyObj);
+
+    return metricsObj;
+}
+
+Napi::Value STDSEngineWrapper::SetMetricsEnabled(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsBoolean()) {
+        Napi::TypeError::New(env, "Boolean expected").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    engine_->setMetricsEnabled(info[0].As<Napi::Boolean>().Value());
+
+    return env.Undefined();
+}
+
+Napi::Value STDSEngineWrapper::StartEngineThread(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsFunction()) {
+        Napi::TypeError::New(env, "Function expected").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+    if (engine_thread_running_) {
+        Napi::Error::New(env, "Engine thread already running").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    size_t queue_size = 65536;
+    if (info.Length() > 1 && info[1].IsObject()) {
+        Napi::Object options = info[1].As<Napi::Object>();
+        if (options.Has("queueSize")) {
+            queue_size = options.Get("queueSize").As<Napi::Number>().Uint32Value();
+        }
+        if (options.Has("maxBatch")) {
+            max_batch_ = std::max(1u, options.Get("maxBatch").As<Napi::Number>().Uint32Value());
+        }
+    }
+
+    decision_tsfn_ = Napi::ThreadSafeFunction::New(
+        env,
+        info[0].As<Napi::Function>(),
+        "DecisionCallback",
+        0,
+        1
+    );
+
+    tick_ring_.reset(new stds::SpscRing<TickEvent>(queue_size));
+    engine_thread_running_ = true;
+    engine_thread_ = std::thread(&STDSEngineWrapper::EngineThreadLoop, this);
+
+    return env.Undefined();
+}
+
+Napi::Value STDSEngineWrapper::EnqueueTick(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsObject()) {
+        Napi::TypeError::New(env, "Object expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    if (!engine_thread_running_) {
+        Napi::Error::New(env, "Engine thread not running").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    Napi::Object dataObj = info[0].As<Napi::Object>();
+    TickEvent tick;
+    tick.data.open = dataObj.Get("open").As<Napi::Number>().DoubleValue();
+    tick.data.high = dataObj.Get("high").As<Napi::Number>().DoubleValue();
+    tick.data.low = dataObj.Get("low").As<Napi::Number>().DoubleValue();
+    tick.data.close = dataObj.Get("close").As<Napi::Number>().DoubleValue();
+    tick.data.volume = dataObj.Get("volume").As<Napi::Number>().DoubleValue();
+    tick.seq = next_tick_seq_;
+    tick.enqueued = std::chrono::steady_clock::now();
+
+    // Ring full: report backpressure instead of blocking the event loop
+    if (!tick_ring_->tryPush(tick)) {
+        return env.Null();
+    }
+    ++next_tick_seq_;
+
+    // Pairs with the parked flag store so a parking consumer cannot miss the tick
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (engine_thread_parked_) {
+        std::lock_guard<std::mutex> lock(park_mutex_);
+        park_cv_.notify_one();
+    }
+
+    return Napi::Number::New(env, static_cast<double>(tick.seq));
+}
+
+Napi::Value STDSEngineWrapper::StopEngineThreadJS(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    StopEngineThread();
+
+    return env.Undefined();
+}
+
+void STDSEngineWrapper::StopEngineThread() {
+    if (!engine_thread_.joinable()) {
+        return;
+    }
+
+    // The loop drains queued ticks before it exits
+    engine_thread_running_ = false;
+    {
+        std::lock_guard<std::mutex> lock(park_mutex_);
+        park_cv_.notify_one();
+    }
+    engine_thread_.join();
+    decision_tsfn_.Release();
+}
+
+void STDSEngineWrapper::EngineThreadLoop() {
+    TickEvent tick;
+
+    while (true) {
+        std::vector<DecisionEvent>* batch = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(engine_mutex_);
+            while ((!batch || batch->size() < max_batch_) && tick_ring_->tryPop(tick)) {
+                if (!batch) {
+                    batch = new std::vector<DecisionEvent>();
+                    batch->reserve(max_batch_);
+                }
+                DecisionEvent event;
+                event.seq = tick.seq;
+                std::string decision = engine_->processNewData(tick.data);
+                event.decision = decision == "BUY" ? "BUY"
+                               : decision == "SELL" ? "SELL"
+                               : decision == "HOLD" ? "HOLD" : "NONE";
+                event.latency_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - tick.enqueued).count();
+                batch->push_back(event);
+            }
+        }
+
+        if (batch) {
+            if (decision_tsfn_.NonBlockingCall(batch, DeliverDecisions) != napi_ok) {
+                delete batch;
+            }
+            continue;
+        }
+
+        if (!engine_thread_running_) {
+            break;
+        }
+
+        // Idle: park until the producer signals or a short timeout elapses
+        std::unique_lock<std::mutex> lock(park_mutex_);
+        engine_thread_parked_ = true;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (tick_ring_->size() == 0 && engine_thread_running_) {
+            park_cv_.wait_for(lock, std::chrono::milliseconds(1));
+        }
+        engine_thread_parked_ = false;
+    }
+}
+
+void STDSEngineWrapper::DeliverDecisions(Napi::Env env, Napi::Function jsCallback,
+                                         std::vector<DecisionEvent>* batch) {
+    if (env != nullptr && jsCallback != nullptr) {
+        Napi::Array decisions = Napi::Array::New(env, batch->size());
+        for (size_t i = 0; i < batch->size(); ++i) {
+            const DecisionEvent& event = (*batch)[i];
+            Napi::Object decisionObj = Napi::Object::New(env);
+            decisionObj.Set("seq", Napi::Number::New(env, static_cast<double>(event.seq)));
+            decisionObj.Set("decision", Napi::String::New(env, event.decision));
+            decisionObj.Set("latencyNs", Napi::Number::New(env, static_cast<double>(event.latency_ns)));
+            decisions.Set(static_cast<uint32_t>(i), decisionObj);
+        }
+        jsCallback.Call({decisions});
+    }
+    delete batch;
+}
+
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
     return STDSEngineWrapper::Init(env, exports);
 }
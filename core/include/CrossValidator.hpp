@@ -0,0 +1,126 @@
+#ifndef CROSS_VALIDATOR_HPP
+#define CROSS_VALIDATOR_HPP
+
+#include "SequenceTree.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace stds {
+
+/**
+ * @brief Per-bar outcome flags produced by STDSEngine::label
+ */
+enum WindowLabel : uint8_t {
+    LABEL_BUY = 1,   // A buy at this bar reaches the take-profit within the lookahead
+    LABEL_SELL = 2   // A sell at this bar reaches the take-profit within the lookahead
+};
+
+/**
+ * @brief Parameters for time-series cross-validation
+ */
+struct CrossValidationOptions {
+    int folds = 5;
+    int embargo = 0;       // Extra bars dropped from training after each test block
+    int num_threads = 0;   // 0 = one fold worker per hardware core
+};
+
+/**
+ * @brief Out-of-sample results of one fold
+ */
+struct FoldResult {
+    size_t test_begin = 0;      // First entry bar of the test block
+    size_t test_end = 0;        // One past the last entry bar of the test block
+    size_t train_windows = 0;
+    size_t purged_windows = 0;  // Windows dropped because they overlap the test block
+    size_t test_windows = 0;
+    size_t buy_trades = 0;      // Test windows answered with BUY
+    size_t sell_trades = 0;     // Test windows answered with SELL
+    size_t correct = 0;         // Trades whose label confirms the decision
+    double accuracy = 0.0;      // correct / trades
+    double coverage = 0.0;      // trades / test_windows
+};
+
+/**
+ * @brief Results of all folds and their totals
+ */
+struct CrossValidationReport {
+    std::vector<FoldResult> folds;
+    size_t test_windows = 0;
+    size_t trades = 0;
+    size_t correct = 0;
+    double accuracy = 0.0;
+    double coverage = 0.0;
+    uint64_t elapsed_us = 0;
+    bool rolling_window_ignored = false;  // Folds trained on every unpurged window, not a trailing one
+    bool fixed_tree = false;              // Exact lookups used the compile-time specialized tree
+};
+
+/**
+ * @brief Purged and embargoed k-fold cross-validation over labeled windows
+ *
+ * The entry bars are split into contiguous test blocks. A window with entry
+ * bar d reads bars [d - sequence_length, d + lookahead_days), so training
+ * windows whose span overlaps the span of the test block are purged, and the
+ * embargo extends that exclusion past the end of the block. Folds train their
+ * own tree on worker threads and share the symbol and label arrays read-only.
+ */
+class CrossValidator {
+private:
+    int num_bins_;
+    int sequence_length_;
+    int lookahead_days_;
+    double confidence_threshold_;
+    bool use_fixed_tree_;
+    bool approximate_;
+    ApproximateQueryOptions approximate_options_;
+    int rolling_window_;
+
+    FoldResult runFold(const std::vector<int>& symbols, const std::vector<uint8_t>& labels,
+                       size_t test_begin, size_t test_end, size_t embargo) const;
+
+public:
+    /**
+     * @brief Constructor
+     * @param num_bins Symbol alphabet size
+     * @param sequence_length Symbols per window
+     * @param lookahead_days Bars a label looks ahead
+     * @param confidence_threshold Threshold for BUY/SELL decisions
+     */
+    CrossValidator(int num_bins, int sequence_length, int lookahead_days,
+                   double confidence_threshold);
+
+    /**
+     * @brief Train folds into a compile-time specialized tree when one matches
+     *        (num_bins, sequence_length), as STDSEngine does with use_fixed_tree
+     */
+    void setUseFixedTree(bool use_fixed_tree) { use_fixed_tree_ = use_fixed_tree; }
+
+    /**
+     * @brief Answer test windows missing from the fold's tree with the best
+     *        approximate match, as STDSEngine::processNewData does
+     * @param options Approximate lookup parameters; max_results is forced to 1
+     */
+    void setApproximateFallback(const ApproximateQueryOptions& options);
+
+    /**
+     * @brief Record the engine's trailing window, which k-fold splits cannot
+     *        apply; run() flags it as ignored in the report
+     */
+    void setRollingWindow(int rolling_window) { rolling_window_ = rolling_window; }
+
+    /**
+     * @brief Run every fold
+     * @param symbols Symbol i is the return from bar i to bar i+1
+     * @param labels WindowLabel flags per bar
+     * @param options Fold count, embargo and worker threads
+     * @param report Output per-fold and total results
+     * @return False if there are fewer windows than folds or fewer than two folds
+     */
+    bool run(const std::vector<int>& symbols, const std::vector<uint8_t>& labels,
+             const CrossValidationOptions& options, CrossValidationReport& report) const;
+};
+
+}  // namespace stds
+
+#endif  // CROSS_VALIDATOR_HPP
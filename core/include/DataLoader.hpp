@@ -0,0 +1,83 @@
+#ifndef DATA_LOADER_HPP
+#define DATA_LOADER_HPP
+
+#include "Normalizer.hpp"
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace stds {
+
+/**
+ * @brief Marker for bars without a parseable date
+ */
+const int64_t kNoTimestamp = std::numeric_limits<int64_t>::min();
+
+/**
+ * @brief Summary of a dataset ingestion
+ */
+struct LoadReport {
+    size_t files = 0;
+    size_t failed_files = 0;
+    size_t rows = 0;             // Bars kept after merging
+    size_t malformed_rows = 0;   // Rows skipped because a field did not parse
+    size_t undated_rows = 0;     // Rows whose Date column did not parse
+    size_t duplicates = 0;       // Bars dropped because their timestamp was already seen
+    size_t gaps = 0;             // Spacings wider than max_gap_ratio x the median spacing
+};
+
+/**
+ * @brief Concurrent CSV loader for datasets split across several files
+ */
+class DataLoader {
+private:
+    int num_threads_;
+    double max_gap_ratio_;
+    
+public:
+    /**
+     * @brief Constructor
+     * @param num_threads Parser threads, 0 for one per hardware core
+     * @param max_gap_ratio Spacing, relative to the median, above which a gap is reported
+     */
+    explicit DataLoader(int num_threads = 0, double max_gap_ratio = 4.0);
+    
+    /**
+     * @brief Parse a date such as "2024-01-02", "2024-01-02 09:30:00", "20240102" or an epoch in seconds
+     * @return Seconds since the Unix epoch (UTC), or kNoTimestamp
+     */
+    static int64_t parseTimestamp(const std::string& text);
+    
+    /**
+     * @brief Check whether a path names a directory
+     */
+    static bool isDirectory(const std::string& path);
+    
+    /**
+     * @brief List the .csv files of a directory, sorted by name
+     */
+    static std::vector<std::string> listCSVFiles(const std::string& directory);
+    
+    /**
+     * @brief Parse files in parallel and merge them in timestamp order
+     *
+     * Files are expected in Date,Open,High,Low,Close,Volume format with a
+     * header line. If every row is dated the bars are merged by timestamp and
+     * duplicates are dropped; otherwise files are concatenated in list order.
+     *
+     * @param filenames Files to load
+     * @param data Output bars
+     * @param timestamps Output timestamps, parallel to data
+     * @param report Output ingestion summary
+     * @return True if every file was read and at least one bar was loaded
+     */
+    bool load(const std::vector<std::string>& filenames,
+              std::vector<OHLCV>& data,
+              std::vector<int64_t>& timestamps,
+              LoadReport& report) const;
+};
+
+}  // namespace stds
+
+#endif  // DATA_LOADER_HPP
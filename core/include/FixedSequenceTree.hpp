@@ -0,0 +1,274 @@
+#ifndef FIXED_SEQUENCE_TREE_HPP
+#define FIXED_SEQUENCE_TREE_HPP
+
+#include "SequenceNode.hpp"
+#include "SequenceTree.hpp"
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace stds {
+
+/**
+ * @brief Full-length sequence store used on the decision path
+ *
+ * Sequences are passed as raw arrays of the configured sequence length.
+ */
+class SequenceIndex {
+public:
+    virtual ~SequenceIndex() {}
+    
+    /**
+     * @brief Insert a sequence with its labels
+     */
+    virtual void insertSequence(const int* sequence, bool buy_signal, bool sell_signal) = 0;
+    
+    /**
+     * @brief Remove a previously inserted sequence
+     * @return True if the sequence was found and removed
+     */
+    virtual bool removeSequence(const int* sequence, bool buy_signal, bool sell_signal) = 0;
+    
+    /**
+     * @brief Decision for a sequence
+     * @return "BUY", "SELL", "HOLD", "NONE", or nullptr if the sequence is not stored
+     */
+    virtual const char* query(const int* sequence) const = 0;
+    
+    /**
+     * @brief Number of live nodes, including the root
+     */
+    virtual uint32_t getNodeCount() const = 0;
+};
+
+namespace detail {
+
+/**
+ * @brief Compile-time unrolled descent through Remaining levels
+ */
+template <int Bins, int Remaining>
+struct FixedDescent {
+    template <typename Node>
+    static uint32_t find(const Node* nodes, uint32_t node, const int* sequence) {
+        if (static_cast<unsigned>(*sequence) >= static_cast<unsigned>(Bins)) {
+            return 0;
+        }
+        node = nodes[node].children[*sequence];
+        return node == 0 ? 0 : FixedDescent<Bins, Remaining - 1>::find(nodes, node, sequence + 1);
+    }
+};
+
+template <int Bins>
+struct FixedDescent<Bins, 0> {
+    template <typename Node>
+    static uint32_t find(const Node*, uint32_t node, const int*) {
+        return node;
+    }
+};
+
+constexpr uint64_t power(uint64_t base, int exponent) {
+    return exponent == 0 ? 1 : base * power(base, exponent - 1);
+}
+
+constexpr bool fitsInKey(uint64_t base, int exponent, uint64_t limit) {
+    return exponent == 0 ? true : (limit / base >= 1 && fitsInKey(base, exponent - 1, limit / base));
+}
+
+}  // namespace detail
+
+/**
+ * @brief Pack a runtime (num_bins, sequence_length) shape into one key
+ */
+constexpr uint64_t packShape(int num_bins, int sequence_length) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(num_bins)) << 32) |
+           static_cast<uint32_t>(sequence_length);
+}
+
+/**
+ * @brief SequenceTree specialization for a fixed alphabet size and depth
+ *
+ * Nodes live in a contiguous pool with fixed-size child arrays indexed by
+ * symbol, so a lookup is Depth array loads with no map traversal. Child index
+ * 0 means "absent" since the root never appears as a child.
+ */
+template <int Bins, int Depth>
+class FixedSequenceTree : public SequenceIndex {
+    static_assert(Bins > 1 && Depth > 0, "FixedSequenceTree needs at least two bins and one level");
+    static_assert(detail::fitsInKey(Bins, Depth, std::numeric_limits<uint64_t>::max()), "Bins^Depth must fit in a 64-bit key");
+    
+private:
+    enum Decision : uint8_t { DECISION_NONE, DECISION_BUY, DECISION_SELL, DECISION_HOLD };
+    
+    struct Node {
+        uint32_t children[Bins];
+        uint64_t weight;
+        Stats stats;
+        uint8_t decision;
+    };
+    
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> free_nodes_;
+    double confidence_threshold_;
+    
+    uint32_t allocateNode() {
+        uint32_t index;
+        if (!free_nodes_.empty()) {
+            index = free_nodes_.back();
+            free_nodes_.pop_back();
+        } else {
+            index = static_cast<uint32_t>(nodes_.size());
+            nodes_.push_back(Node());
+        }
+        nodes_[index] = Node();
+        return index;
+    }
+    
+    static bool validSequence(const int* sequence) {
+        for (int i = 0; i < Depth; ++i) {
+            if (static_cast<unsigned>(sequence[i]) >= static_cast<unsigned>(Bins)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    static Decision toDecision(const char* synthesis) {
+        switch (synthesis[0]) {
+            case 'B': return DECISION_BUY;
+            case 'S': return DECISION_SELL;
+            case 'H': return DECISION_HOLD;
+            default: return DECISION_NONE;
+        }
+    }
+    
+    void updateDecision(Node& node) {
+        node.decision = toDecision(SequenceTree::synthesize(node.weight, node.stats, confidence_threshold_));
+    }
+    
+public:
+    static constexpr int kBins = Bins;
+    static constexpr int kDepth = Depth;
+    
+    /**
+     * @brief Number of distinct full-length sequences
+     */
+    static constexpr uint64_t keySpace() { return detail::power(Bins, Depth); }
+    
+    /**
+     * @brief Pack a full-length sequence into a unique base-Bins integer key
+     */
+    static constexpr uint64_t packKey(const int* sequence, int length = Depth, uint64_t key = 0) {
+        return length == 0 ? key : packKey(sequence + 1, length - 1, key * Bins + static_cast<uint64_t>(sequence[0]));
+    }
+    
+    /**
+     * @brief Key of this (Bins, Depth) shape for makeFixedSequenceTree's dispatch
+     */
+    static constexpr uint64_t shapeKey() { return packShape(Bins, Depth); }
+    
+    /**
+     * @brief Constructor
+     * @param confidence_threshold Threshold for decision confidence (default 0.70)
+     */
+    explicit FixedSequenceTree(double confidence_threshold = 0.70)
+        : confidence_threshold_(confidence_threshold) {
+        nodes_.push_back(Node());
+    }
+    
+    void insertSequence(const int* sequence, bool buy_signal, bool sell_signal) override {
+        if (!validSequence(sequence)) {
+            return;
+        }
+        
+        uint32_t current = 0;
+        for (int i = 0; i < Depth; ++i) {
+            uint32_t child = nodes_[current].children[sequence[i]];
+            if (child == 0) {
+                child = allocateNode();
+                nodes_[current].children[sequence[i]] = child;
+            }
+            current = child;
+            nodes_[current].weight++;
+        }
+        
+        Node& last = nodes_[current];
+        if (buy_signal) {
+            last.stats.buy_wins++;
+        }
+        if (sell_signal) {
+            last.stats.sell_wins++;
+        }
+        if (!buy_signal && !sell_signal) {
+            last.stats.hold_count++;
+        }
+        updateDecision(last);
+    }
+    
+    bool removeSequence(const int* sequence, bool buy_signal, bool sell_signal) override {
+        if (!validSequence(sequence)) {
+            return false;
+        }
+        
+        uint32_t path[Depth + 1];
+        path[0] = 0;
+        for (int i = 0; i < Depth; ++i) {
+            path[i + 1] = nodes_[path[i]].children[sequence[i]];
+            if (path[i + 1] == 0 || nodes_[path[i + 1]].weight == 0) {
+                return false;
+            }
+        }
+        
+        for (int i = 1; i <= Depth; ++i) {
+            nodes_[path[i]].weight--;
+        }
+        
+        Node& last = nodes_[path[Depth]];
+        if (buy_signal && last.stats.buy_wins > 0) {
+            last.stats.buy_wins--;
+        }
+        if (sell_signal && last.stats.sell_wins > 0) {
+            last.stats.sell_wins--;
+        }
+        if (!buy_signal && !sell_signal && last.stats.hold_count > 0) {
+            last.stats.hold_count--;
+        }
+        updateDecision(last);
+        
+        // Reclaim unsupported nodes, deepest first
+        for (int i = Depth; i > 0 && nodes_[path[i]].weight == 0; --i) {
+            nodes_[path[i - 1]].children[sequence[i - 1]] = 0;
+            free_nodes_.push_back(path[i]);
+        }
+        
+        return true;
+    }
+    
+    const char* query(const int* sequence) const override {
+        static const char* const kDecisions[] = { "NONE", "BUY", "SELL", "HOLD" };
+        
+        uint32_t node = detail::FixedDescent<Bins, Depth>::find(nodes_.data(), 0, sequence);
+        if (node == 0) {
+            return nullptr;
+        }
+        return kDecisions[nodes_[node].decision];
+    }
+    
+    uint32_t getNodeCount() const override {
+        return static_cast<uint32_t>(nodes_.size() - free_nodes_.size());
+    }
+};
+
+/**
+ * @brief Create the FixedSequenceTree specialization matching a runtime shape
+ * @param num_bins Alphabet size
+ * @param sequence_length Sequence depth
+ * @param confidence_threshold Threshold for decision confidence
+ * @return The specialized tree, or nullptr if no specialization is compiled in
+ */
+std::unique_ptr<SequenceIndex> makeFixedSequenceTree(int num_bins, int sequence_length,
+                                                     double confidence_threshold);
+
+}  // namespace stds
+
+#endif  // FIXED_SEQUENCE_TREE_HPP
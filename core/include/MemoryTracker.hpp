@@ -0,0 +1,103 @@
+#ifndef MEMORY_TRACKER_HPP
+#define MEMORY_TRACKER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace stds {
+
+/**
+ * @brief Live and peak byte counts of the allocations routed through it
+ */
+class MemoryTracker {
+private:
+    std::atomic<uint64_t> live_bytes_;
+    std::atomic<uint64_t> peak_bytes_;
+    std::atomic<uint64_t> allocations_;
+
+public:
+    MemoryTracker() : live_bytes_(0), peak_bytes_(0), allocations_(0) {}
+
+    MemoryTracker(const MemoryTracker&) = delete;
+    MemoryTracker& operator=(const MemoryTracker&) = delete;
+
+    void allocated(size_t bytes) {
+        uint64_t live = live_bytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        allocations_.fetch_add(1, std::memory_order_relaxed);
+
+        uint64_t peak = peak_bytes_.load(std::memory_order_relaxed);
+        while (live > peak &&
+               !peak_bytes_.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+        }
+    }
+
+    void released(size_t bytes) {
+        live_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get the bytes currently allocated
+     */
+    uint64_t getLiveBytes() const { return live_bytes_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the highest live byte count seen
+     */
+    uint64_t getPeakBytes() const { return peak_bytes_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the number of allocations made
+     */
+    uint64_t getAllocations() const { return allocations_.load(std::memory_order_relaxed); }
+};
+
+/**
+ * @brief Standard allocator that reports to a MemoryTracker
+ *
+ * Containers built with a null tracker allocate exactly like std::allocator.
+ * The tracker must outlive every container that uses it.
+ */
+template <typename T>
+class TrackingAllocator {
+public:
+    typedef T value_type;
+
+    MemoryTracker* tracker;
+
+    explicit TrackingAllocator(MemoryTracker* memory_tracker = nullptr) noexcept
+        : tracker(memory_tracker) {}
+
+    template <typename U>
+    TrackingAllocator(const TrackingAllocator<U>& other) noexcept : tracker(other.tracker) {}
+
+    T* allocate(size_t n) {
+        T* p = static_cast<T*>(::operator new(n * sizeof(T)));
+        if (tracker) {
+            tracker->allocated(n * sizeof(T));
+        }
+        return p;
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (tracker) {
+            tracker->released(n * sizeof(T));
+        }
+        ::operator delete(p);
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const TrackingAllocator<T>& a, const TrackingAllocator<U>& b) noexcept {
+    return a.tracker == b.tracker;
+}
+
+template <typename T, typename U>
+bool operator!=(const TrackingAllocator<T>& a, const TrackingAllocator<U>& b) noexcept {
+    return a.tracker != b.tracker;
+}
+
+}  // namespace stds
+
+#endif  // MEMORY_TRACKER_HPP
@@ -0,0 +1,199 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace stds {
+
+/**
+ * @brief Instrumented stages of the engine
+ */
+enum class Stage {
+    PARSE,       // CSV parsing and merging
+    FIT,         // Normalizer fitting
+    SYMBOLIZE,   // Log-return quantization of history
+    LABEL,       // Profitability labeling of history
+    INSERT,      // Tree insertions and removals
+    TICK,        // processNewData end to end
+    COUNT
+};
+
+/**
+ * @brief Event counters
+ */
+enum class Counter {
+    ROWS_LOADED,
+    WINDOWS_INSERTED,
+    WINDOWS_EXPIRED,
+    TICKS,
+    APPROXIMATE_QUERIES,
+    APPROXIMATE_TIMEOUTS,
+    SYNTHESES,   // Decision syntheses at updated nodes; too short to time individually
+    COUNT
+};
+
+/**
+ * @brief Aggregated timing of one stage
+ */
+struct StageSnapshot {
+    uint64_t calls = 0;
+    uint64_t total_ns = 0;
+    uint64_t max_ns = 0;
+};
+
+/**
+ * @brief Point-in-time copy of all metrics
+ */
+struct MetricsSnapshot {
+    bool compiled_in = false;
+    bool enabled = false;
+    StageSnapshot stages[static_cast<int>(Stage::COUNT)];
+    uint64_t counters[static_cast<int>(Counter::COUNT)] = {};
+    
+    // Per-tick latency distribution
+    uint64_t tick_count = 0;
+    uint64_t tick_p50_ns = 0;
+    uint64_t tick_p99_ns = 0;
+    uint64_t tick_p999_ns = 0;
+    
+    // Tree footprint
+    uint64_t tree_nodes = 0;
+    uint64_t tree_bytes = 0;
+    uint64_t node_allocations = 0;
+    
+    // Price history footprint
+    uint64_t history_bars = 0;
+    uint64_t history_bytes = 0;
+};
+
+/**
+ * @brief Log-linear latency histogram with lock-free recording
+ *
+ * Each power of two is split into 8 sub-buckets, giving percentiles within
+ * 12.5% of the true value from 1 ns to about an hour.
+ */
+class LatencyHistogram {
+public:
+    static const int kSubBuckets = 8;
+    static const int kBuckets = 40 * kSubBuckets;
+    
+    LatencyHistogram();
+    
+    void record(uint64_t ns);
+    
+    /**
+     * @brief Upper bound of the bucket holding the q-th quantile (0 < q <= 1)
+     */
+    uint64_t percentile(double q) const;
+    
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    
+    void reset();
+    
+private:
+    std::atomic<uint64_t> buckets_[kBuckets];
+    std::atomic<uint64_t> count_;
+    
+    static int bucketFor(uint64_t ns);
+    static uint64_t bucketUpperBound(int bucket);
+};
+
+/**
+ * @brief Low-overhead engine instrumentation
+ *
+ * Recording is compiled in when the core is built with STDS_ENABLE_METRICS
+ * and can be switched off at run time; when off, each probe costs one
+ * relaxed load.
+ */
+class Metrics {
+public:
+    Metrics();
+    
+    /**
+     * @brief True if the core was built with STDS_ENABLE_METRICS
+     */
+    static bool compiledIn();
+    
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+    void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    
+    void recordStage(Stage stage, uint64_t ns);
+    void recordTick(uint64_t ns);
+    
+    void increment(Counter counter, uint64_t amount = 1) {
+        if (enabled()) {
+            counters_[static_cast<int>(counter)].fetch_add(amount, std::memory_order_relaxed);
+        }
+    }
+    
+    /**
+     * @brief Copy the current values; tree fields are left for the owner to fill
+     */
+    MetricsSnapshot snapshot() const;
+    
+    void reset();
+    
+private:
+    struct StageCounters {
+        std::atomic<uint64_t> calls;
+        std::atomic<uint64_t> total_ns;
+        std::atomic<uint64_t> max_ns;
+    };
+    
+    std::atomic<bool> enabled_;
+    StageCounters stages_[static_cast<int>(Stage::COUNT)];
+    std::atomic<uint64_t> counters_[static_cast<int>(Counter::COUNT)];
+    LatencyHistogram tick_latency_;
+};
+
+/**
+ * @brief Records the lifetime of a scope as one call of a stage
+ */
+class ScopedStageTimer {
+public:
+    ScopedStageTimer(Metrics* metrics, Stage stage)
+        : metrics_(metrics && metrics->enabled() ? metrics : nullptr), stage_(stage) {
+        if (metrics_) {
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+    
+    ~ScopedStageTimer() {
+        if (metrics_) {
+            uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start_).count();
+            if (stage_ == Stage::TICK) {
+                metrics_->recordTick(ns);
+            } else {
+                metrics_->recordStage(stage_, ns);
+            }
+        }
+    }
+    
+private:
+    ScopedStageTimer(const ScopedStageTimer&);
+    ScopedStageTimer& operator=(const ScopedStageTimer&);
+    
+    Metrics* metrics_;
+    Stage stage_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace stds
+
+// Probes used inside the core; they compile to nothing without STDS_ENABLE_METRICS
+#define STDS_METRICS_CONCAT_(a, b) a##b
+#define STDS_METRICS_CONCAT(a, b) STDS_METRICS_CONCAT_(a, b)
+
+#ifdef STDS_ENABLE_METRICS
+#define STDS_TIME_STAGE(metrics, stage) \
+    ::stds::ScopedStageTimer STDS_METRICS_CONCAT(stds_stage_timer_, __LINE__)((metrics), (stage))
+#define STDS_COUNT(metrics, counter, amount) (metrics)->increment((counter), (amount))
+#else
+#define STDS_TIME_STAGE(metrics, stage) ((void)0)
+#define STDS_COUNT(metrics, counter, amount) ((void)0)
+#endif
+
+#endif  // METRICS_HPP
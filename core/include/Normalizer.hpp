@@ -47,6 +47,12 @@ public:
      */
     void fit(const std::vector<OHLCV>& data);
     
+    /**
+     * @brief Fit the normalizer to a column of close prices
+     * @param closes Close prices in chronological order
+     */
+    void fit(const std::vector<double>& closes);
+    
     /**
      * @brief Transform a log-return into a discrete symbol
      * @param log_return The log-return value
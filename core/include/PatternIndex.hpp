@@ -0,0 +1,118 @@
+#ifndef PATTERN_INDEX_HPP
+#define PATTERN_INDEX_HPP
+
+#include "SequenceNode.hpp"
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace stds {
+
+/**
+ * @brief Ranking score for confident patterns
+ */
+enum class PatternScore {
+    SUPPORT,    // Weight, ties broken by win ratio
+    WIN_RATIO,  // Winning side's share of the weight, ties broken by weight
+    WILSON      // Lower bound of the 95% Wilson interval of the win ratio
+};
+
+/**
+ * @brief Which confident decisions to return from a pattern query
+ */
+enum class PatternSide {
+    BUY,
+    SELL,
+    BOTH
+};
+
+/**
+ * @brief A confident pattern with its outcome statistics
+ */
+struct RankedPattern {
+    std::vector<int> sequence;  // Symbol path from the root
+    uint32_t node_id = 0;
+    uint64_t weight = 0;
+    Stats stats;
+    bool is_buy = false;        // BUY if true, SELL otherwise
+    double score = 0.0;
+};
+
+/**
+ * @brief Ranked index of the patterns whose synthesis is BUY or SELL
+ *
+ * SequenceTree reports every change of a pattern's statistics, so the index
+ * stays current in O(log n) per insertion or removal. Each side is kept as an
+ * ordered set, so the top K are read off the front in O(K).
+ */
+class PatternIndex {
+private:
+    struct Key {
+        double primary;
+        double secondary;
+        uint32_t node_id;
+
+        bool operator<(const Key& other) const {
+            if (primary != other.primary) {
+                return primary > other.primary;
+            }
+            if (secondary != other.secondary) {
+                return secondary > other.secondary;
+            }
+            return node_id < other.node_id;
+        }
+    };
+
+    struct Entry {
+        Key key;
+        RankedPattern pattern;
+    };
+
+    PatternScore score_;
+    std::set<Key> buy_ranking_;
+    std::set<Key> sell_ranking_;
+    std::unordered_map<uint32_t, Entry> entries_;
+
+    Key makeKey(const SequenceNode* node, bool is_buy) const;
+    std::set<Key>& rankingFor(bool is_buy) { return is_buy ? buy_ranking_ : sell_ranking_; }
+
+public:
+    /**
+     * @brief Constructor
+     * @param score Ranking used by top()
+     */
+    explicit PatternIndex(PatternScore score = PatternScore::WILSON);
+
+    /**
+     * @brief Record the current statistics of a pattern's terminal node
+     * @param sequence Symbol path of the node
+     * @param node Terminal node whose synthesis was just recalculated
+     */
+    void update(const std::vector<int>& sequence, const SequenceNode* node);
+
+    /**
+     * @brief Forget a node that was reclaimed
+     */
+    void erase(uint32_t node_id);
+
+    /**
+     * @brief Get the highest ranked patterns
+     * @param k Maximum number of patterns
+     * @param side Decision to return, or both merged by score
+     */
+    std::vector<RankedPattern> top(size_t k, PatternSide side = PatternSide::BOTH) const;
+
+    /**
+     * @brief Get the number of indexed BUY and SELL patterns
+     */
+    size_t size() const { return entries_.size(); }
+
+    /**
+     * @brief Get the ranking score
+     */
+    PatternScore getScore() const { return score_; }
+};
+
+}  // namespace stds
+
+#endif  // PATTERN_INDEX_HPP
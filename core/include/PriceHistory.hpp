@@ -0,0 +1,95 @@
+#ifndef PRICE_HISTORY_HPP
+#define PRICE_HISTORY_HPP
+
+#include "Normalizer.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace stds {
+
+/**
+ * @brief Storage precision for the open/high/low/volume columns
+ */
+enum class ColumnPrecision {
+    FLOAT64,  // Exact copies of the loaded values
+    FLOAT32   // Half the footprint; about 7 significant digits
+};
+
+/**
+ * @brief Column-oriented OHLCV history
+ *
+ * Close prices live in their own contiguous double column, which is all that
+ * symbolization and labeling read. The open, high, low and volume columns are
+ * only needed to rebuild bars and can be stored as float32. Close is never
+ * narrowed, so decisions do not depend on the chosen precision.
+ */
+class PriceHistory {
+private:
+    enum Column { OPEN, HIGH, LOW, VOLUME, COLUMN_COUNT };
+
+    ColumnPrecision precision_;
+    std::vector<double> close_;
+    std::vector<double> wide_[COLUMN_COUNT];    // Used with FLOAT64
+    std::vector<float> narrow_[COLUMN_COUNT];   // Used with FLOAT32
+
+public:
+    /**
+     * @brief Constructor
+     * @param precision Storage precision for the non-close columns
+     */
+    explicit PriceHistory(ColumnPrecision precision = ColumnPrecision::FLOAT64);
+
+    /**
+     * @brief Replace the history with the given bars
+     */
+    void assign(const std::vector<OHLCV>& bars);
+
+    /**
+     * @brief Append one bar
+     */
+    void push_back(const OHLCV& bar);
+
+    /**
+     * @brief Remove every bar
+     */
+    void clear();
+
+    /**
+     * @brief Get the number of bars
+     */
+    size_t size() const { return close_.size(); }
+
+    /**
+     * @brief Check whether the history holds no bars
+     */
+    bool empty() const { return close_.empty(); }
+
+    /**
+     * @brief Get the close price of a bar
+     */
+    double close(size_t index) const { return close_[index]; }
+
+    /**
+     * @brief Get the contiguous close column
+     */
+    const std::vector<double>& closes() const { return close_; }
+
+    /**
+     * @brief Rebuild a full bar, widening the narrowed columns
+     */
+    OHLCV bar(size_t index) const;
+
+    /**
+     * @brief Get the storage precision of the non-close columns
+     */
+    ColumnPrecision getPrecision() const { return precision_; }
+
+    /**
+     * @brief Get the bytes held by all columns, counting reserved capacity
+     */
+    size_t memoryBytes() const;
+};
+
+}  // namespace stds
+
+#endif  // PRICE_HISTORY_HPP
@@ -1,8 +1,15 @@
 #ifndef STDS_ENGINE_HPP
 #define STDS_ENGINE_HPP
 
+#include "CrossValidator.hpp"
+#include "DataLoader.hpp"
+#include "FixedSequenceTree.hpp"
+#include "Metrics.hpp"
 #include "Normalizer.hpp"
+#include "PriceHistory.hpp"
 #include "SequenceTree.hpp"
+#include <deque>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -17,6 +24,47 @@ struct STDSConfig {
     double confidence_threshold = 0.70;
     int lookahead_days = 5;
     double take_profit_threshold = 0.02;  // 2% profit target
+    
+    // Approximate lookup for windows that are not stored in the tree
+    int approximate_max_distance = 0;     // 0 = exact matches only
+    DistanceMetric approximate_metric = DistanceMetric::L1;
+    uint64_t approximate_time_budget_us = 200;
+    
+    // Trailing window in bars; 0 keeps every window ever seen
+    int rolling_window = 0;
+    
+    // Also maintain a compile-time specialized tree when one matches
+    // (num_bins, sequence_length) and answer exact queries from it. Opt-in:
+    // every window is then inserted into both trees
+    bool use_fixed_tree = false;
+    
+    // Record stage timings and tick latency (when compiled with STDS_ENABLE_METRICS)
+    bool enable_metrics = true;
+    
+    // Dataset ingestion
+    int load_threads = 0;        // 0 = one parser thread per hardware core
+    double max_gap_ratio = 4.0;  // Spacing above this multiple of the median is a gap
+    
+    // Storage of the open/high/low/volume history columns; close stays double
+    ColumnPrecision history_precision = ColumnPrecision::FLOAT64;
+    
+    // Ranked index of BUY/SELL patterns. Opt-in: it is maintained on every tree update
+    bool enable_pattern_index = false;
+    PatternScore pattern_score = PatternScore::WILSON;
+    
+    // Journal tree changes so getTreeDelta can return only what changed.
+    // Opt-in: the journal and id index cost about as much memory as the nodes
+    bool enable_delta_feed = false;
+};
+
+/**
+ * @brief A labeled sequence currently held in the rolling-window tree
+ */
+struct LabeledWindow {
+    size_t data_index;        // Index of the entry bar in historical data
+    std::vector<int> sequence;
+    bool buy_signal;
+    bool sell_signal;
 };
 
 /**
@@ -27,9 +75,19 @@ private:
     STDSConfig config_;
     Normalizer normalizer_;
     SequenceTree tree_;
-    std::vector<OHLCV> historical_data_;
+    std::unique_ptr<SequenceIndex> fixed_tree_;  // Null when no specialization matches
+    std::unique_ptr<PatternIndex> pattern_index_;  // Null when disabled
+    PriceHistory history_;
+    std::vector<int64_t> timestamps_;  // Timestamps of the loaded bars
+    LoadReport load_report_;
+    mutable Metrics metrics_;
     std::vector<int> symbol_sequence_;
     
+    // Rolling-window state, only used when config_.rolling_window > 0
+    bool rolling_active_;
+    size_t next_label_index_;
+    std::deque<LabeledWindow> rolling_windows_;
+    
     /**
      * @brief Check if a buy/sell signal would be profitable
      * @param start_index Starting index in historical data
@@ -38,6 +96,33 @@ private:
      */
     bool checkProfitability(size_t start_index, bool is_buy) const;
     
+    /**
+     * @brief Insert a labeled window into every tree the engine maintains
+     */
+    void insertWindow(const std::vector<int>& sequence, bool buy_signal, bool sell_signal);
+    
+    /**
+     * @brief Remove a labeled window from every tree the engine maintains
+     */
+    void removeWindow(const std::vector<int>& sequence, bool buy_signal, bool sell_signal);
+    
+    /**
+     * @brief Build the symbol window whose entry bar is data_index
+     * @param data_index Index of the entry bar, at least sequence_length
+     */
+    std::vector<int> windowAt(size_t data_index) const;
+    
+    /**
+     * @brief Insert windows whose lookahead has completed and expire windows
+     *        older than rolling_window bars
+     */
+    void advanceRollingWindow();
+    
+    /**
+     * @brief Remove every window held by the rolling-window tree and stop rolling
+     */
+    void clearRollingWindows();
+    
 public:
     /**
      * @brief Constructor
@@ -47,16 +132,72 @@ public:
     
     /**
      * @brief Load historical data from CSV file
-     * @param filename Path to CSV file with OHLCV data
+     * @param filename Path to CSV file with OHLCV data, or to a directory of CSV files
      * @return True if successful, false otherwise
      */
     bool loadData(const std::string& filename);
     
+    /**
+     * @brief Load historical data split across several CSV files
+     *
+     * Files are parsed concurrently and merged in timestamp order before the
+     * normalizer is fitted once over the combined data.
+     *
+     * @param filenames Paths to CSV files with OHLCV data
+     * @return True if successful, false otherwise
+     */
+    bool loadData(const std::vector<std::string>& filenames);
+    
+    /**
+     * @brief Load historical data already held in memory
+     * @param data OHLCV bars in chronological order
+     * @return True if successful, false otherwise
+     */
+    bool setData(const std::vector<OHLCV>& data);
+    
+    /**
+     * @brief Convert historical data to symbols
+     * @return One symbol per bar after the first; symbol i is the return from bar i to bar i+1
+     */
+    std::vector<int> symbolize() const;
+    
+    /**
+     * @brief Label every bar of historical data
+     * @return One combination of WindowLabel flags per bar
+     */
+    std::vector<uint8_t> label() const;
+    
     /**
      * @brief Train the model on historical data
+     *
+     * With rolling_window > 0 only the trailing window is inserted, and
+     * processNewData keeps the tree current at O(sequence_length) per bar.
      */
     void train();
     
+    /**
+     * @brief Measure out-of-sample decision quality with purged k-fold cross-validation
+     *
+     * History is symbolized and labeled once; folds then train on worker
+     * threads, purging training windows whose bars overlap the test block.
+     * The trained tree is left untouched. Bin edges come from the normalizer
+     * fitted over the whole history. Misses use the approximate fallback when
+     * configured; rolling_window is not applied and the report says so.
+     *
+     * @param options Fold count, embargo and worker threads
+     * @param report Output per-fold accuracy and coverage
+     * @return False if there is not enough data for the requested folds
+     */
+    bool crossValidate(const CrossValidationOptions& options, CrossValidationReport& report) const;
+    
+    /**
+     * @brief Build the validator crossValidate runs, configured from this engine
+     *
+     * Together with symbolize() and label() this captures everything the
+     * folds read, so callers can run them without holding the engine.
+     */
+    CrossValidator makeCrossValidator() const;
+    
     /**
      * @brief Process a new OHLCV data point and get decision
      * @param data New OHLCV data
@@ -69,6 +210,31 @@ public:
      */
     const SequenceTree& getTree() const { return tree_; }
     
+    /**
+     * @brief Get the loaded bars, including those appended by processNewData
+     */
+    const PriceHistory& getHistory() const { return history_; }
+    
+    /**
+     * @brief Get the timestamps of the loaded bars (kNoTimestamp where undated)
+     */
+    const std::vector<int64_t>& getTimestamps() const { return timestamps_; }
+    
+    /**
+     * @brief Get the summary of the last loadData call
+     */
+    const LoadReport& getLoadReport() const { return load_report_; }
+    
+    /**
+     * @brief Get the windows held by the rolling-window tree, oldest first
+     */
+    const std::deque<LabeledWindow>& getRollingWindows() const { return rolling_windows_; }
+    
+    /**
+     * @brief Check whether queries use a compile-time specialized tree
+     */
+    bool usesFixedTree() const { return fixed_tree_ != nullptr; }
+    
     /**
      * @brief Get the normalizer
      */
@@ -79,10 +245,53 @@ public:
      */
     void setNodeCallback(NodeCallback callback) { tree_.setNodeCallback(callback); }
     
+    /**
+     * @brief Get stage timings, counters, tick latency percentiles and tree footprint
+     */
+    MetricsSnapshot getMetrics() const;
+    
+    /**
+     * @brief Switch metrics recording on or off at run time
+     */
+    void setMetricsEnabled(bool enabled) { metrics_.setEnabled(enabled && Metrics::compiledIn()); }
+    
+    /**
+     * @brief Clear all recorded metrics
+     */
+    void resetMetrics() { metrics_.reset(); }
+    
     /**
      * @brief Get tree as JSON
      */
     std::string getTreeJSON() const { return tree_.toJSON(); }
+    
+    /**
+     * @brief Get the highest ranked BUY/SELL patterns
+     * @param k Maximum number of patterns
+     * @param side Decision to return, or both merged by score
+     * @return Patterns in rank order; empty when the pattern index is disabled
+     */
+    std::vector<RankedPattern> getTopPatterns(size_t k, PatternSide side = PatternSide::BOTH) const;
+    
+    /**
+     * @brief Get shape, memory and decision statistics of the tree
+     */
+    TreeStats getTreeStats() const { return tree_.getStats(); }
+    
+    /**
+     * @brief Get the tree version, incremented by every insertion and removal
+     */
+    uint64_t getTreeVersion() const { return tree_.getVersion(); }
+    
+    /**
+     * @brief Get the identifier of the tree instance, new for every engine
+     */
+    uint64_t getTreeEpoch() const { return tree_.getEpoch(); }
+    
+    /**
+     * @brief Get the nodes that changed after a tree version, as JSON
+     */
+    std::string getTreeDelta(uint64_t since) const { return tree_.getDelta(since); }
 };
 
 }  // namespace stds
@@ -1,7 +1,9 @@
 #ifndef SEQUENCE_NODE_HPP
 #define SEQUENCE_NODE_HPP
 
+#include "MemoryTracker.hpp"
 #include <cstdint>
+#include <functional>
 #include <map>
 #include <string>
 
@@ -16,19 +18,30 @@ struct Stats {
     uint32_t hold_count = 0;
 };
 
+struct SequenceNode;
+
+/**
+ * @brief Children of a node by symbol, allocated through the owning tree's tracker
+ */
+using ChildMap = std::map<int, SequenceNode*, std::less<int>,
+                          TrackingAllocator<std::pair<const int, SequenceNode*>>>;
+
 /**
  * @brief Node in the Suffix-like Tree representing a market state sequence
  */
 struct SequenceNode {
+    // Stats sits with the 32-bit fields so parent_id costs no padding
     uint32_t id;
+    uint32_t parent_id;  // Id of the parent node (0 for the root's children and the root itself)
     int symbol;
-    uint64_t weight;  // Frequency of the subsequence
-    std::map<int, SequenceNode*> children;
     Stats stats;
+    uint64_t weight;  // Frequency of the subsequence
+    ChildMap children;
     std::string synthesis;  // Decision: "BUY", "SELL", "HOLD", or "NONE"
     
-    SequenceNode(uint32_t node_id, int sym)
-        : id(node_id), symbol(sym), weight(0), synthesis("NONE") {}
+    SequenceNode(uint32_t node_id, int sym, uint32_t parent = 0, MemoryTracker* tracker = nullptr)
+        : id(node_id), parent_id(parent), symbol(sym), weight(0),
+          children(std::less<int>(), ChildMap::allocator_type(tracker)), synthesis("NONE") {}
     
     ~SequenceNode() {
         for (auto& pair : children) {
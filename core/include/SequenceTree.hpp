@@ -1,9 +1,13 @@
 #ifndef SEQUENCE_TREE_HPP
 #define SEQUENCE_TREE_HPP
 
+#include "Metrics.hpp"
+#include "PatternIndex.hpp"
 #include "SequenceNode.hpp"
 #include <vector>
 #include <functional>
+#include <string>
+#include <unordered_map>
 
 namespace stds {
 
@@ -12,15 +16,113 @@ namespace stds {
  */
 using NodeCallback = std::function<void(const SequenceNode*)>;
 
+/**
+ * @brief Distance metric between two symbol sequences
+ */
+enum class DistanceMetric {
+    L1,       // Sum of absolute bin differences
+    HAMMING   // Number of positions with a different bin
+};
+
+/**
+ * @brief A stored pattern found by an approximate query
+ */
+struct ApproximateMatch {
+    std::vector<int> sequence;   // Symbol path of the matched pattern
+    int distance;                // Distance to the queried sequence
+    const SequenceNode* node;    // Terminal node of the pattern
+};
+
+/**
+ * @brief Parameters for an approximate query
+ */
+struct ApproximateQueryOptions {
+    int max_distance = 1;
+    DistanceMetric metric = DistanceMetric::L1;
+    size_t max_results = 1;
+    uint64_t time_budget_us = 200;  // 0 disables the budget
+};
+
+/**
+ * @brief Result of an approximate query
+ */
+struct ApproximateQueryResult {
+    std::vector<ApproximateMatch> matches;  // Sorted by weight desc, then distance asc
+    size_t nodes_visited = 0;
+    bool timed_out = false;                 // True if the time budget cut the search short
+};
+
+/**
+ * @brief Shape, memory and decision breakdown of a tree
+ */
+struct TreeStats {
+    uint64_t nodes = 0;
+    uint64_t leaves = 0;
+    uint64_t max_depth = 0;
+    
+    // Bytes by component
+    uint64_t node_bytes = 0;        // SequenceNode objects
+    uint64_t child_map_bytes = 0;   // Child map entries (tracked)
+    uint64_t index_bytes = 0;       // Id lookup table used by the delta feed (tracked)
+    uint64_t journal_bytes = 0;     // Change journal (tracked)
+    uint64_t total_bytes = 0;
+    uint64_t peak_tracked_bytes = 0;  // High-water mark of the tracked components
+    
+    std::vector<uint64_t> nodes_per_depth;    // Index 0 is the root
+    std::vector<uint64_t> branching;          // branching[k] = nodes with k children
+    std::vector<uint64_t> support_histogram;  // Bucket k = non-root nodes with weight in [2^k, 2^(k+1))
+    
+    // Non-root nodes by synthesis
+    uint64_t buy_nodes = 0;
+    uint64_t sell_nodes = 0;
+    uint64_t hold_nodes = 0;
+    uint64_t none_nodes = 0;
+};
+
 /**
  * @brief Suffix-like Tree for sequential trading decision system
  */
 class SequenceTree {
 private:
+    // Declared first so they outlive the containers that report to them
+    MemoryTracker child_memory_;
+    MemoryTracker index_memory_;
+    MemoryTracker journal_memory_;
+    
     SequenceNode* root_;
     uint32_t next_id_;
+    uint32_t node_count_;
+    uint64_t node_allocations_;
     double confidence_threshold_;
     NodeCallback node_callback_;
+    Metrics* metrics_;
+    PatternIndex* pattern_index_;
+    
+    // Change journal: every node touched by a mutation, tagged with the tree
+    // version the mutation produced. Versions below journal_floor_ have been
+    // compacted away. The journal and the id index are only kept while
+    // delta_journal_ is set.
+    struct JournalEntry {
+        uint64_t version;
+        uint32_t node_id;
+    };
+    uint64_t epoch_;  // Identifies this tree instance; versions restart with it
+    uint64_t version_;
+    uint64_t journal_floor_;
+    bool delta_journal_;
+    std::vector<JournalEntry, TrackingAllocator<JournalEntry>> journal_;
+    std::unordered_map<uint32_t, SequenceNode*, std::hash<uint32_t>, std::equal_to<uint32_t>,
+                       TrackingAllocator<std::pair<const uint32_t, SequenceNode*>>> nodes_by_id_;
+    
+    /**
+     * @brief Record that a node changed in the current version
+     */
+    void journalNode(uint32_t node_id);
+    
+    /**
+     * @brief Drop the older half of the journal once it outgrows the tree
+     */
+    void compactJournal();
     
     /**
      * @brief Calculate synthesis decision for a node
@@ -40,6 +142,15 @@ public:
      */
     ~SequenceTree();
     
+    /**
+     * @brief Decision rule shared by every tree implementation
+     * @param weight Number of sequences that ended at the node
+     * @param stats Outcome statistics at the node
+     * @param confidence_threshold Threshold for BUY/SELL decisions
+     * @return "BUY", "SELL", "HOLD", or "NONE"
+     */
+    static const char* synthesize(uint64_t weight, const Stats& stats, double confidence_threshold);
+    
     /**
      * @brief Insert a sequence into the tree
      * @param sequence Vector of symbols representing market states
@@ -48,6 +159,19 @@ public:
      */
     void insertSequence(const std::vector<int>& sequence, bool buy_signal, bool sell_signal);
     
+    /**
+     * @brief Remove a previously inserted sequence from the tree
+     *
+     * Reverses insertSequence: decrements weight along the path and the
+     * statistics at the final node, then reclaims nodes left without support.
+     *
+     * @param sequence Vector of symbols that was inserted
+     * @param buy_signal Buy label it was inserted with
+     * @param sell_signal Sell label it was inserted with
+     * @return True if the sequence was found and removed
+     */
+    bool removeSequence(const std::vector<int>& sequence, bool buy_signal, bool sell_signal);
+    
     /**
      * @brief Query the tree for a decision given a sequence
      * @param sequence Vector of symbols representing current market state
@@ -55,6 +179,28 @@ public:
      */
     std::string query(const std::vector<int>& sequence) const;
     
+    /**
+     * @brief Find the node reached by following a sequence from the root
+     * @return The node, or nullptr if the sequence is not stored
+     */
+    const SequenceNode* findNode(const std::vector<int>& sequence) const;
+    
+    /**
+     * @brief Find the best-supported patterns within a bounded distance of a sequence
+     *
+     * Best-first search ordered by accumulated distance, then depth, so the
+     * closest full-length windows are reached first. Since weights never
+     * increase along a path, subtrees are pruned once their root cannot beat
+     * the current max_results-th match, or once the accumulated distance
+     * exceeds max_distance. Matches rank by weight, then distance.
+     *
+     * @param sequence Vector of symbols representing current market state
+     * @param options Distance bound, metric, result count and time budget
+     * @return Matches found before the search completed or ran out of time
+     */
+    ApproximateQueryResult queryApproximate(const std::vector<int>& sequence,
+                                            const ApproximateQueryOptions& options) const;
+    
     /**
      * @brief Get the root node
      */
@@ -65,16 +211,87 @@ public:
      */
     void setNodeCallback(NodeCallback callback) { node_callback_ = callback; }
     
+    /**
+     * @brief Report synthesis timings to a metrics sink (nullptr to detach)
+     */
+    void setMetrics(Metrics* metrics) { metrics_ = metrics; }
+    
+    /**
+     * @brief Keep a pattern index current with every statistics change (nullptr to detach)
+     *
+     * Attach before inserting; patterns already in the tree are not replayed.
+     */
+    void setPatternIndex(PatternIndex* index) { pattern_index_ = index; }
+    
+    /**
+     * @brief Get the number of nodes allocated since construction
+     */
+    uint64_t getNodeAllocations() const { return node_allocations_; }
+    
     /**
      * @brief Get total number of nodes in the tree
      */
-    uint32_t getNodeCount() const { return next_id_; }
+    uint32_t getNodeCount() const { return node_count_; }
+    
+    /**
+     * @brief Get the bytes held by the tree, without walking it
+     *
+     * Node objects plus the tracked child maps, id index and journal.
+     */
+    uint64_t getMemoryBytes() const;
+    
+    /**
+     * @brief Collect shape, memory and decision statistics in one pass
+     */
+    TreeStats getStats() const;
     
     /**
      * @brief Serialize tree to JSON format
      */
     std::string toJSON() const;
     
+    /**
+     * @brief Get the tree version, incremented by every insertion and removal
+     */
+    uint64_t getVersion() const { return version_; }
+    
+    /**
+     * @brief Get the identifier of this tree instance
+     *
+     * Drawn when the tree is constructed and below 2^53, so it survives a
+     * round trip through a JavaScript number. A client holding versions of a
+     * tree with another epoch must discard its copy.
+     */
+    uint64_t getEpoch() const { return epoch_; }
+    
+    /**
+     * @brief Keep the change journal and id index that incremental deltas need
+     *
+     * Off by default: on large trees they take about as much memory as the
+     * nodes. Enabling indexes the current nodes and starts the journal at the
+     * current version; disabling frees both. While off, getDelta always
+     * returns a full snapshot.
+     */
+    void setDeltaJournal(bool enabled);
+    
+    /**
+     * @brief Check whether incremental deltas are journaled
+     */
+    bool hasDeltaJournal() const { return delta_journal_; }
+    
+    /**
+     * @brief Serialize the nodes that changed after a given version
+     *
+     * Produces {"epoch":E,"version":V,"since":S,"reset":R,"fields":[...],"nodes":[...],"removed":[...]}
+     * where each node is a positional array in "fields" order, with parents
+     * before children. When the journal is off, since is 0, ahead of the
+     * current version, or older than the journal reaches back, reset is true
+     * and nodes holds the whole tree, which replaces the client's copy.
+     *
+     * @param since Version the client is synchronized to (0 for a full snapshot)
+     */
+    std::string getDelta(uint64_t since) const;
+    
 private:
     /**
      * @brief Helper function to serialize a node recursively
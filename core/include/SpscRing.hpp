@@ -0,0 +1,101 @@
+#ifndef SPSC_RING_HPP
+#define SPSC_RING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace stds {
+
+/**
+ * @brief Bounded lock-free single-producer/single-consumer queue
+ *
+ * One thread may call tryPush and another tryPop concurrently. Head and tail
+ * live on separate cache lines, and each side caches the other's index so
+ * the other side's line is only read when the ring looks full or empty.
+ */
+template <typename T>
+class SpscRing {
+private:
+    static const size_t kCacheLine = 64;
+    
+    std::vector<T> slots_;
+    size_t mask_;
+    
+    // Padding keeps each side's index on its own cache line without relying
+    // on over-aligned allocation
+    char pad0_[kCacheLine];
+    std::atomic<size_t> head_;  // Next slot to pop, written by the consumer
+    size_t cached_tail_;        // Consumer's view of tail_
+    
+    char pad1_[kCacheLine];
+    std::atomic<size_t> tail_;  // Next slot to push, written by the producer
+    size_t cached_head_;        // Producer's view of head_
+    
+    char pad2_[kCacheLine];
+    
+    static size_t roundUpPow2(size_t value) {
+        size_t result = 2;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+    
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Minimum number of queued elements, rounded up to a power of two
+     */
+    explicit SpscRing(size_t capacity)
+        : slots_(roundUpPow2(capacity)), mask_(slots_.size() - 1),
+          head_(0), cached_tail_(0), tail_(0), cached_head_(0) {
+    }
+    
+    /**
+     * @brief Enqueue an element (producer thread only)
+     * @return False if the ring is full
+     */
+    bool tryPush(const T& value) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ == slots_.size()) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ == slots_.size()) {
+                return false;
+            }
+        }
+        slots_[tail & mask_] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+    
+    /**
+     * @brief Dequeue an element (consumer thread only)
+     * @return False if the ring is empty
+     */
+    bool tryPop(T& value) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) {
+                return false;
+            }
+        }
+        value = slots_[head & mask_];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+    
+    /**
+     * @brief Approximate number of queued elements (any thread)
+     */
+    size_t size() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+    
+    size_t capacity() const { return slots_.size(); }
+};
+
+}  // namespace stds
+
+#endif  // SPSC_RING_HPP
@@ -0,0 +1,173 @@
+#include "CrossValidator.hpp"
+#include "FixedSequenceTree.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+namespace stds {
+
+CrossValidator::CrossValidator(int num_bins, int sequence_length, int lookahead_days,
+                               double confidence_threshold)
+    : num_bins_(num_bins), sequence_length_(sequence_length),
+      lookahead_days_(lookahead_days), confidence_threshold_(confidence_threshold),
+      use_fixed_tree_(false), approximate_(false), rolling_window_(0) {
+}
+
+void CrossValidator::setApproximateFallback(const ApproximateQueryOptions& options) {
+    approximate_ = true;
+    approximate_options_ = options;
+    approximate_options_.max_results = 1;
+}
+
+FoldResult CrossValidator::runFold(const std::vector<int>& symbols,
+                                   const std::vector<uint8_t>& labels,
+                                   size_t test_begin, size_t test_end, size_t embargo) const {
+    FoldResult result;
+    result.test_begin = test_begin;
+    result.test_end = test_end;
+
+    const size_t length = static_cast<size_t>(sequence_length_);
+    const size_t lookahead = static_cast<size_t>(lookahead_days_);
+    const size_t first = length;
+    const size_t last = symbols.size();  // One past the last entry bar with a full window
+
+    // Bars read by the test block are [test_begin - length, test_end - 1 + lookahead);
+    // a training window at d reads [d - length, d + lookahead)
+    const size_t blocked_begin = test_begin - length;
+    const size_t blocked_end = test_end - 1 + lookahead + embargo;
+
+    // Same trees the engine answers from: the fixed tree when enabled and one
+    // matches, the dynamic tree otherwise or when misses fall back to approximate lookup
+    std::unique_ptr<SequenceIndex> fixed;
+    if (use_fixed_tree_) {
+        fixed = makeFixedSequenceTree(num_bins_, sequence_length_, confidence_threshold_);
+    }
+    SequenceTree dynamic(confidence_threshold_);
+    const bool use_dynamic = !fixed || approximate_;
+
+    for (size_t d = first; d < last; ++d) {
+        if (d + lookahead > blocked_begin && d - length < blocked_end) {
+            if (d < test_begin || d >= test_end) {
+                ++result.purged_windows;
+            }
+            continue;
+        }
+
+        const int* window = symbols.data() + d - length;
+        bool buy_signal = (labels[d] & LABEL_BUY) != 0;
+        bool sell_signal = (labels[d] & LABEL_SELL) != 0;
+        if (fixed) {
+            fixed->insertSequence(window, buy_signal, sell_signal);
+        }
+        if (use_dynamic) {
+            dynamic.insertSequence(std::vector<int>(window, window + length), buy_signal, sell_signal);
+        }
+        ++result.train_windows;
+    }
+
+    std::vector<int> sequence(length);
+    for (size_t d = test_begin; d < test_end; ++d) {
+        const int* window = symbols.data() + d - length;
+        const char* decision = nullptr;
+        sequence.assign(window, window + length);
+        if (fixed) {
+            decision = fixed->query(window);
+        } else {
+            const SequenceNode* node = dynamic.findNode(sequence);
+            decision = node ? node->synthesis.c_str() : nullptr;
+        }
+        if (!decision && approximate_) {
+            ApproximateQueryResult match = dynamic.queryApproximate(sequence, approximate_options_);
+            if (!match.matches.empty()) {
+                decision = match.matches.front().node->synthesis.c_str();
+            }
+        }
+        ++result.test_windows;
+
+        if (!decision) {
+            continue;
+        }
+        std::string answer(decision);
+        if (answer == "BUY") {
+            ++result.buy_trades;
+            result.correct += (labels[d] & LABEL_BUY) ? 1 : 0;
+        } else if (answer == "SELL") {
+            ++result.sell_trades;
+            result.correct += (labels[d] & LABEL_SELL) ? 1 : 0;
+        }
+    }
+
+    size_t trades = result.buy_trades + result.sell_trades;
+    result.accuracy = trades > 0 ? static_cast<double>(result.correct) / trades : 0.0;
+    result.coverage = result.test_windows > 0
+        ? static_cast<double>(trades) / result.test_windows : 0.0;
+
+    return result;
+}
+
+bool CrossValidator::run(const std::vector<int>& symbols, const std::vector<uint8_t>& labels,
+                         const CrossValidationOptions& options, CrossValidationReport& report) const {
+    auto start = std::chrono::steady_clock::now();
+    report = CrossValidationReport();
+
+    const size_t length = static_cast<size_t>(sequence_length_);
+    const size_t windows = symbols.size() > length ? symbols.size() - length : 0;
+    if (options.folds < 2 || windows < static_cast<size_t>(options.folds)) {
+        std::cerr << "Not enough windows for " << options.folds << "-fold cross-validation" << std::endl;
+        return false;
+    }
+    if (labels.size() < symbols.size()) {
+        std::cerr << "Labels do not cover every window" << std::endl;
+        return false;
+    }
+
+    const size_t folds = static_cast<size_t>(options.folds);
+    const size_t embargo = static_cast<size_t>(std::max(0, options.embargo));
+    report.folds.resize(folds);
+
+    // Folds are independent; workers take the next one until all are done
+    std::atomic<size_t> next_fold(0);
+    auto worker = [&]() {
+        for (size_t f = next_fold++; f < folds; f = next_fold++) {
+            size_t test_begin = length + f * windows / folds;
+            size_t test_end = length + (f + 1) * windows / folds;
+            report.folds[f] = runFold(symbols, labels, test_begin, test_end, embargo);
+        }
+    };
+
+    size_t num_threads = options.num_threads > 0
+        ? static_cast<size_t>(options.num_threads)
+        : std::max(1u, std::thread::hardware_concurrency());
+    num_threads = std::min(num_threads, folds);
+
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < num_threads; ++t) {
+        workers.push_back(std::thread(worker));
+    }
+    worker();
+    for (auto& thread : workers) {
+        thread.join();
+    }
+
+    for (const FoldResult& fold : report.folds) {
+        report.test_windows += fold.test_windows;
+        report.trades += fold.buy_trades + fold.sell_trades;
+        report.correct += fold.correct;
+    }
+    report.accuracy = report.trades > 0 ? static_cast<double>(report.correct) / report.trades : 0.0;
+    report.coverage = report.test_windows > 0
+        ? static_cast<double>(report.trades) / report.test_windows : 0.0;
+    report.elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    // A trailing window has no counterpart in k-fold splits, which train on both sides
+    report.rolling_window_ignored = rolling_window_ > 0;
+    report.fixed_tree = use_fixed_tree_ &&
+        makeFixedSequenceTree(num_bins_, sequence_length_, confidence_threshold_) != nullptr;
+
+    return true;
+}
+
+}  // namespace stds
@@ -0,0 +1,317 @@
+#include "DataLoader.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <dirent.h>
+#include <sys/stat.h>
+
+namespace stds {
+
+namespace {
+
+/**
+ * @brief Bars parsed from a single file
+ */
+struct ParsedFile {
+    std::vector<OHLCV> bars;
+    std::vector<int64_t> timestamps;
+    size_t malformed_rows = 0;
+    size_t undated_rows = 0;
+    bool ok = false;
+};
+
+/**
+ * @brief Days since 1970-01-01 for a proleptic Gregorian date
+ */
+int64_t daysFromCivil(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+/**
+ * @brief Parse a number spanning exactly [begin, end)
+ */
+bool parseField(const char* begin, const char* end, double& value) {
+    if (begin == end) {
+        return false;
+    }
+    char* parsed_end = nullptr;
+    value = std::strtod(begin, &parsed_end);
+    return parsed_end == end;
+}
+
+void parseFile(const std::string& filename, ParsedFile& out) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open file: " << filename << std::endl;
+        return;
+    }
+    
+    std::string line;
+    
+    // Skip header line
+    std::getline(file, line);
+    
+    while (std::getline(file, line)) {
+        if (!line.empty() && line[line.size() - 1] == '\r') {
+            line.erase(line.size() - 1);
+        }
+        if (line.empty()) {
+            continue;
+        }
+        
+        // Split Date,Open,High,Low,Close,Volume in place
+        const char* fields[7];
+        size_t count = 0;
+        const char* begin = line.c_str();
+        const char* end = begin + line.size();
+        fields[count++] = begin;
+        for (const char* p = begin; p != end && count < 7; ++p) {
+            if (*p == ',') {
+                fields[count++] = p + 1;
+            }
+        }
+        if (count < 6) {
+            ++out.malformed_rows;
+            continue;
+        }
+        if (count < 7) {
+            fields[count] = end + 1;
+        }
+        
+        OHLCV data;
+        double* targets[5] = { &data.open, &data.high, &data.low, &data.close, &data.volume };
+        bool valid = true;
+        for (size_t i = 0; i < 5 && valid; ++i) {
+            valid = parseField(fields[i + 1], fields[i + 2] - 1, *targets[i]);
+        }
+        if (!valid) {
+            ++out.malformed_rows;
+            continue;
+        }
+        
+        int64_t timestamp = DataLoader::parseTimestamp(std::string(fields[0], fields[1] - 1));
+        if (timestamp == kNoTimestamp) {
+            ++out.undated_rows;
+        }
+        
+        out.bars.push_back(data);
+        out.timestamps.push_back(timestamp);
+    }
+    
+    out.ok = true;
+}
+
+}  // namespace
+
+DataLoader::DataLoader(int num_threads, double max_gap_ratio)
+    : num_threads_(num_threads), max_gap_ratio_(max_gap_ratio) {
+}
+
+int64_t DataLoader::parseTimestamp(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \"");
+    size_t end = text.find_last_not_of(" \"");
+    if (begin == std::string::npos) {
+        return kNoTimestamp;
+    }
+    std::string value = text.substr(begin, end - begin + 1);
+    
+    int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
+    if (value.find_first_not_of("0123456789") == std::string::npos) {
+        // Compact YYYYMMDD; as epoch seconds eight digits would only reach 1973
+        if (value.size() == 8) {
+            year = std::atoi(value.substr(0, 4).c_str());
+            month = std::atoi(value.substr(4, 2).c_str());
+            day = std::atoi(value.substr(6, 2).c_str());
+            if (month >= 1 && month <= 12 && day >= 1 && day <= 31) {
+                return daysFromCivil(year, month, day) * 86400;
+            }
+        }
+        
+        // Plain epoch seconds
+        return std::strtoll(value.c_str(), nullptr, 10);
+    }
+    
+    char sep = 0;
+    int fields = std::sscanf(value.c_str(), "%4d-%2d-%2d%c%2d:%2d:%2d",
+                             &year, &month, &day, &sep, &hour, &minute, &second);
+    if (fields < 3 || month < 1 || month > 12 || day < 1 || day > 31) {
+        return kNoTimestamp;
+    }
+    if (fields > 3 && sep != ' ' && sep != 'T') {
+        return kNoTimestamp;
+    }
+    
+    return daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+}
+
+bool DataLoader::isDirectory(const std::string& path) {
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+std::vector<std::string> DataLoader::listCSVFiles(const std::string& directory) {
+    std::vector<std::string> files;
+    DIR* dir = opendir(directory.c_str());
+    if (!dir) {
+        std::cerr << "Failed to open directory: " << directory << std::endl;
+        return files;
+    }
+    
+    while (struct dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name.size() > 4 && name.compare(name.size() - 4, 4, ".csv") == 0) {
+            files.push_back(directory + "/" + name);
+        }
+    }
+    closedir(dir);
+    
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+bool DataLoader::load(const std::vector<std::string>& filenames,
+                      std::vector<OHLCV>& data,
+                      std::vector<int64_t>& timestamps,
+                      LoadReport& report) const {
+    report = LoadReport();
+    report.files = filenames.size();
+    data.clear();
+    timestamps.clear();
+    
+    // Parse files on a pool of workers pulling from a shared index
+    std::vector<ParsedFile> parsed(filenames.size());
+    size_t num_threads = num_threads_ > 0
+        ? static_cast<size_t>(num_threads_)
+        : std::max(1u, std::thread::hardware_concurrency());
+    num_threads = std::min(num_threads, filenames.size());
+    
+    std::atomic<size_t> next_file(0);
+    auto worker = [&]() {
+        for (size_t i = next_file++; i < filenames.size(); i = next_file++) {
+            parseFile(filenames[i], parsed[i]);
+        }
+    };
+    
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < num_threads; ++t) {
+        workers.push_back(std::thread(worker));
+    }
+    worker();
+    for (auto& thread : workers) {
+        thread.join();
+    }
+    
+    size_t total = 0;
+    for (const auto& file : parsed) {
+        if (!file.ok) {
+            ++report.failed_files;
+        }
+        total += file.bars.size();
+        report.malformed_rows += file.malformed_rows;
+        report.undated_rows += file.undated_rows;
+    }
+    
+    // Concatenate, with files whose first bar is earliest first
+    std::vector<size_t> order(parsed.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    bool dated = report.undated_rows == 0;
+    if (dated) {
+        std::stable_sort(order.begin(), order.end(), [&parsed](size_t a, size_t b) {
+            if (parsed[a].timestamps.empty() || parsed[b].timestamps.empty()) {
+                return !parsed[a].timestamps.empty() && parsed[b].timestamps.empty();
+            }
+            return parsed[a].timestamps.front() < parsed[b].timestamps.front();
+        });
+    }
+    
+    data.reserve(total);
+    timestamps.reserve(total);
+    for (size_t index : order) {
+        data.insert(data.end(), parsed[index].bars.begin(), parsed[index].bars.end());
+        timestamps.insert(timestamps.end(), parsed[index].timestamps.begin(), parsed[index].timestamps.end());
+    }
+    
+    if (dated && !std::is_sorted(timestamps.begin(), timestamps.end())) {
+        // Overlapping files: fall back to a full stable sort by timestamp
+        std::vector<size_t> rows(data.size());
+        for (size_t i = 0; i < rows.size(); ++i) {
+            rows[i] = i;
+        }
+        std::stable_sort(rows.begin(), rows.end(), [&timestamps](size_t a, size_t b) {
+            return timestamps[a] < timestamps[b];
+        });
+        
+        std::vector<OHLCV> sorted_data;
+        std::vector<int64_t> sorted_timestamps;
+        sorted_data.reserve(rows.size());
+        sorted_timestamps.reserve(rows.size());
+        for (size_t row : rows) {
+            sorted_data.push_back(data[row]);
+            sorted_timestamps.push_back(timestamps[row]);
+        }
+        data.swap(sorted_data);
+        timestamps.swap(sorted_timestamps);
+    }
+    
+    if (dated && !data.empty()) {
+        // Drop duplicate timestamps, keeping the first bar seen
+        size_t kept = 1;
+        for (size_t i = 1; i < data.size(); ++i) {
+            if (timestamps[i] == timestamps[kept - 1]) {
+                ++report.duplicates;
+                continue;
+            }
+            data[kept] = data[i];
+            timestamps[kept] = timestamps[i];
+            ++kept;
+        }
+        data.resize(kept);
+        timestamps.resize(kept);
+        
+        // Report spacings well above the median spacing
+        if (data.size() > 2) {
+            std::vector<int64_t> deltas(data.size() - 1);
+            for (size_t i = 1; i < data.size(); ++i) {
+                deltas[i - 1] = timestamps[i] - timestamps[i - 1];
+            }
+            std::vector<int64_t> sorted_deltas(deltas);
+            std::nth_element(sorted_deltas.begin(),
+                             sorted_deltas.begin() + sorted_deltas.size() / 2,
+                             sorted_deltas.end());
+            double limit = max_gap_ratio_ * sorted_deltas[sorted_deltas.size() / 2];
+            for (int64_t delta : deltas) {
+                if (delta > limit) {
+                    ++report.gaps;
+                }
+            }
+        }
+    }
+    
+    report.rows = data.size();
+    
+    if (report.failed_files > 0) {
+        return false;
+    }
+    if (report.malformed_rows > 0) {
+        std::cerr << "Skipped " << report.malformed_rows << " malformed rows" << std::endl;
+    }
+    if (report.duplicates > 0 || report.gaps > 0) {
+        std::cerr << "Merged data has " << report.duplicates << " duplicate bars and "
+                  << report.gaps << " gaps" << std::endl;
+    }
+    
+    return !data.empty();
+}
+
+}  // namespace stds
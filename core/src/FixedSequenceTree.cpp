@@ -0,0 +1,27 @@
+#include "FixedSequenceTree.hpp"
+
+namespace stds {
+
+// Shapes used by production configurations
+template class FixedSequenceTree<10, 5>;
+template class FixedSequenceTree<16, 8>;
+
+std::unique_ptr<SequenceIndex> makeFixedSequenceTree(int num_bins, int sequence_length,
+                                                     double confidence_threshold) {
+    std::unique_ptr<SequenceIndex> tree;
+    
+    switch (packShape(num_bins, sequence_length)) {
+        case FixedSequenceTree<10, 5>::shapeKey():
+            tree.reset(new FixedSequenceTree<10, 5>(confidence_threshold));
+            break;
+        case FixedSequenceTree<16, 8>::shapeKey():
+            tree.reset(new FixedSequenceTree<16, 8>(confidence_threshold));
+            break;
+        default:
+            break;
+    }
+    
+    return tree;
+}
+
+}  // namespace stds
@@ -0,0 +1,134 @@
+#include "Metrics.hpp"
+
+namespace stds {
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+int LatencyHistogram::bucketFor(uint64_t ns) {
+    if (ns < static_cast<uint64_t>(kSubBuckets)) {
+        return static_cast<int>(ns);
+    }
+    
+    // Position of the highest set bit selects the power of two,
+    // the next three bits select the sub-bucket
+    int exponent = 63;
+    while (!(ns & (1ull << exponent))) {
+        --exponent;
+    }
+    int sub = static_cast<int>((ns >> (exponent - 3)) & (kSubBuckets - 1));
+    int bucket = (exponent - 2) * kSubBuckets + sub;
+    return bucket < kBuckets ? bucket : kBuckets - 1;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(int bucket) {
+    if (bucket < kSubBuckets) {
+        return static_cast<uint64_t>(bucket);
+    }
+    int exponent = bucket / kSubBuckets + 2;
+    uint64_t sub = static_cast<uint64_t>(bucket % kSubBuckets);
+    uint64_t width = 1ull << (exponent - 3);
+    return (1ull << exponent) + (sub + 1) * width - 1;
+}
+
+void LatencyHistogram::record(uint64_t ns) {
+    buckets_[bucketFor(ns)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::percentile(double q) const {
+    uint64_t total = 0;
+    uint64_t counts[kBuckets];
+    for (int i = 0; i < kBuckets; ++i) {
+        counts[i] = buckets_[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+    
+    uint64_t rank = static_cast<uint64_t>(q * total + 0.5);
+    if (rank < 1) {
+        rank = 1;
+    }
+    
+    uint64_t seen = 0;
+    for (int i = 0; i < kBuckets; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return bucketUpperBound(i);
+        }
+    }
+    return bucketUpperBound(kBuckets - 1);
+}
+
+void LatencyHistogram::reset() {
+    for (int i = 0; i < kBuckets; ++i) {
+        buckets_[i].store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+}
+
+Metrics::Metrics() : enabled_(compiledIn()) {
+    reset();
+}
+
+bool Metrics::compiledIn() {
+#ifdef STDS_ENABLE_METRICS
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Metrics::recordStage(Stage stage, uint64_t ns) {
+    StageCounters& counters = stages_[static_cast<int>(stage)];
+    counters.calls.fetch_add(1, std::memory_order_relaxed);
+    counters.total_ns.fetch_add(ns, std::memory_order_relaxed);
+    
+    uint64_t max = counters.max_ns.load(std::memory_order_relaxed);
+    while (ns > max && !counters.max_ns.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+    }
+}
+
+void Metrics::recordTick(uint64_t ns) {
+    recordStage(Stage::TICK, ns);
+    tick_latency_.record(ns);
+}
+
+MetricsSnapshot Metrics::snapshot() const {
+    MetricsSnapshot snapshot;
+    snapshot.compiled_in = compiledIn();
+    snapshot.enabled = enabled();
+    
+    for (int i = 0; i < static_cast<int>(Stage::COUNT); ++i) {
+        snapshot.stages[i].calls = stages_[i].calls.load(std::memory_order_relaxed);
+        snapshot.stages[i].total_ns = stages_[i].total_ns.load(std::memory_order_relaxed);
+        snapshot.stages[i].max_ns = stages_[i].max_ns.load(std::memory_order_relaxed);
+    }
+    for (int i = 0; i < static_cast<int>(Counter::COUNT); ++i) {
+        snapshot.counters[i] = counters_[i].load(std::memory_order_relaxed);
+    }
+    
+    snapshot.tick_count = tick_latency_.count();
+    snapshot.tick_p50_ns = tick_latency_.percentile(0.50);
+    snapshot.tick_p99_ns = tick_latency_.percentile(0.99);
+    snapshot.tick_p999_ns = tick_latency_.percentile(0.999);
+    
+    return snapshot;
+}
+
+void Metrics::reset() {
+    for (int i = 0; i < static_cast<int>(Stage::COUNT); ++i) {
+        stages_[i].calls.store(0, std::memory_order_relaxed);
+        stages_[i].total_ns.store(0, std::memory_order_relaxed);
+        stages_[i].max_ns.store(0, std::memory_order_relaxed);
+    }
+    for (int i = 0; i < static_cast<int>(Counter::COUNT); ++i) {
+        counters_[i].store(0, std::memory_order_relaxed);
+    }
+    tick_latency_.reset();
+}
+
+}  // namespace stds
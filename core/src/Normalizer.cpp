@@ -18,16 +18,25 @@ double Normalizer::calculateLogReturn(double prev_close, double curr_close) {
 }
 
 void Normalizer::fit(const std::vector<OHLCV>& data) {
-    if (data.size() < 2) {
+    std::vector<double> closes;
+    closes.reserve(data.size());
+    for (const OHLCV& bar : data) {
+        closes.push_back(bar.close);
+    }
+    fit(closes);
+}
+
+void Normalizer::fit(const std::vector<double>& closes) {
+    if (closes.size() < 2) {
         return;  // Not enough data to calculate returns
     }
     
     // Calculate all log-returns
     std::vector<double> log_returns;
-    log_returns.reserve(data.size() - 1);
+    log_returns.reserve(closes.size() - 1);
     
-    for (size_t i = 1; i < data.size(); ++i) {
-        double log_return = calculateLogReturn(data[i-1].close, data[i].close);
+    for (size_t i = 1; i < closes.size(); ++i) {
+        double log_return = calculateLogReturn(closes[i-1], closes[i]);
         if (std::isfinite(log_return)) {
             log_returns.push_back(log_return);
         }
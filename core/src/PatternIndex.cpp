@@ -0,0 +1,101 @@
+#include "PatternIndex.hpp"
+#include <cmath>
+
+namespace stds {
+
+PatternIndex::PatternIndex(PatternScore score) : score_(score) {
+}
+
+PatternIndex::Key PatternIndex::makeKey(const SequenceNode* node, bool is_buy) const {
+    double weight = static_cast<double>(node->weight);
+    double wins = is_buy ? node->stats.buy_wins : node->stats.sell_wins;
+    double ratio = weight > 0.0 ? wins / weight : 0.0;
+
+    Key key;
+    key.node_id = node->id;
+
+    switch (score_) {
+        case PatternScore::SUPPORT:
+            key.primary = weight;
+            key.secondary = ratio;
+            break;
+        case PatternScore::WIN_RATIO:
+            key.primary = ratio;
+            key.secondary = weight;
+            break;
+        case PatternScore::WILSON: {
+            const double z = 1.96;
+            const double z2 = z * z;
+            double center = ratio + z2 / (2.0 * weight);
+            double margin = z * std::sqrt(ratio * (1.0 - ratio) / weight + z2 / (4.0 * weight * weight));
+            key.primary = (center - margin) / (1.0 + z2 / weight);
+            key.secondary = weight;
+            break;
+        }
+    }
+
+    return key;
+}
+
+void PatternIndex::update(const std::vector<int>& sequence, const SequenceNode* node) {
+    bool is_buy = node->synthesis == "BUY";
+    if (!is_buy && node->synthesis != "SELL") {
+        erase(node->id);
+        return;
+    }
+
+    Key key = makeKey(node, is_buy);
+    auto found = entries_.find(node->id);
+
+    if (found == entries_.end()) {
+        Entry entry;
+        entry.key = key;
+        entry.pattern.sequence = sequence;
+        entry.pattern.node_id = node->id;
+        found = entries_.insert(std::make_pair(node->id, entry)).first;
+    } else {
+        rankingFor(found->second.pattern.is_buy).erase(found->second.key);
+        found->second.key = key;
+    }
+
+    RankedPattern& pattern = found->second.pattern;
+    pattern.weight = node->weight;
+    pattern.stats = node->stats;
+    pattern.is_buy = is_buy;
+    pattern.score = key.primary;
+    rankingFor(is_buy).insert(key);
+}
+
+void PatternIndex::erase(uint32_t node_id) {
+    auto found = entries_.find(node_id);
+    if (found == entries_.end()) {
+        return;
+    }
+
+    rankingFor(found->second.pattern.is_buy).erase(found->second.key);
+    entries_.erase(found);
+}
+
+std::vector<RankedPattern> PatternIndex::top(size_t k, PatternSide side) const {
+    std::vector<RankedPattern> result;
+
+    auto buy = buy_ranking_.begin();
+    auto buy_end = side == PatternSide::SELL ? buy_ranking_.begin() : buy_ranking_.end();
+    auto sell = sell_ranking_.begin();
+    auto sell_end = side == PatternSide::BUY ? sell_ranking_.begin() : sell_ranking_.end();
+
+    // Merge the two rankings, which share one key order
+    while (result.size() < k && (buy != buy_end || sell != sell_end)) {
+        const Key* next;
+        if (sell == sell_end || (buy != buy_end && *buy < *sell)) {
+            next = &*buy++;
+        } else {
+            next = &*sell++;
+        }
+        result.push_back(entries_.find(next->node_id)->second.pattern);
+    }
+
+    return result;
+}
+
+}  // namespace stds
@@ -0,0 +1,77 @@
+#include "PriceHistory.hpp"
+
+namespace stds {
+
+PriceHistory::PriceHistory(ColumnPrecision precision) : precision_(precision) {
+}
+
+void PriceHistory::assign(const std::vector<OHLCV>& bars) {
+    clear();
+
+    close_.reserve(bars.size());
+    for (int c = 0; c < COLUMN_COUNT; ++c) {
+        if (precision_ == ColumnPrecision::FLOAT32) {
+            narrow_[c].reserve(bars.size());
+        } else {
+            wide_[c].reserve(bars.size());
+        }
+    }
+
+    for (const OHLCV& bar : bars) {
+        push_back(bar);
+    }
+}
+
+void PriceHistory::push_back(const OHLCV& bar) {
+    close_.push_back(bar.close);
+
+    if (precision_ == ColumnPrecision::FLOAT32) {
+        narrow_[OPEN].push_back(static_cast<float>(bar.open));
+        narrow_[HIGH].push_back(static_cast<float>(bar.high));
+        narrow_[LOW].push_back(static_cast<float>(bar.low));
+        narrow_[VOLUME].push_back(static_cast<float>(bar.volume));
+    } else {
+        wide_[OPEN].push_back(bar.open);
+        wide_[HIGH].push_back(bar.high);
+        wide_[LOW].push_back(bar.low);
+        wide_[VOLUME].push_back(bar.volume);
+    }
+}
+
+void PriceHistory::clear() {
+    close_.clear();
+    for (int c = 0; c < COLUMN_COUNT; ++c) {
+        wide_[c].clear();
+        narrow_[c].clear();
+    }
+}
+
+OHLCV PriceHistory::bar(size_t index) const {
+    OHLCV result;
+    result.close = close_[index];
+
+    if (precision_ == ColumnPrecision::FLOAT32) {
+        result.open = narrow_[OPEN][index];
+        result.high = narrow_[HIGH][index];
+        result.low = narrow_[LOW][index];
+        result.volume = narrow_[VOLUME][index];
+    } else {
+        result.open = wide_[OPEN][index];
+        result.high = wide_[HIGH][index];
+        result.low = wide_[LOW][index];
+        result.volume = wide_[VOLUME][index];
+    }
+
+    return result;
+}
+
+size_t PriceHistory::memoryBytes() const {
+    size_t bytes = close_.capacity() * sizeof(double);
+    for (int c = 0; c < COLUMN_COUNT; ++c) {
+        bytes += wide_[c].capacity() * sizeof(double);
+        bytes += narrow_[c].capacity() * sizeof(float);
+    }
+    return bytes;
+}
+
+}  // namespace stds
@@ -1,6 +1,4 @@
 #include "STDSEngine.hpp"
-#include <fstream>
-#include <sstream>
 #include <iostream>
 #include <algorithm>
 
@@ -9,73 +7,101 @@ namespace stds {
 STDSEngine::STDSEngine(const STDSConfig& config)
     : config_(config),
       normalizer_(config.num_bins),
-      tree_(config.confidence_threshold) {
+      tree_(config.confidence_threshold),
+      history_(config.history_precision),
+      rolling_active_(false),
+      next_label_index_(0) {
+    metrics_.setEnabled(config_.enable_metrics && Metrics::compiledIn());
+    tree_.setMetrics(&metrics_);
+    tree_.setDeltaJournal(config_.enable_delta_feed);
+    
+    if (config_.enable_pattern_index) {
+        pattern_index_.reset(new PatternIndex(config_.pattern_score));
+        tree_.setPatternIndex(pattern_index_.get());
+    }
+    
+    if (config_.use_fixed_tree) {
+        fixed_tree_ = makeFixedSequenceTree(config_.num_bins, config_.sequence_length,
+                                            config_.confidence_threshold);
+    }
 }
 
 bool STDSEngine::loadData(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open file: " << filename << std::endl;
-        return false;
+    if (DataLoader::isDirectory(filename)) {
+        std::vector<std::string> files = DataLoader::listCSVFiles(filename);
+        if (files.empty()) {
+            std::cerr << "No CSV files in directory: " << filename << std::endl;
+            return false;
+        }
+        return loadData(files);
     }
     
-    historical_data_.clear();
-    std::string line;
-    
-    // Skip header line
-    std::getline(file, line);
+    return loadData(std::vector<std::string>(1, filename));
+}
+
+bool STDSEngine::loadData(const std::vector<std::string>& filenames) {
+    // Parse into locals so a failed load keeps the previous history and bin edges
+    DataLoader loader(config_.load_threads, config_.max_gap_ratio);
+    std::vector<OHLCV> data;
+    std::vector<int64_t> timestamps;
+    LoadReport report;
+    bool success;
+    {
+        STDS_TIME_STAGE(&metrics_, Stage::PARSE);
+        success = loader.load(filenames, data, timestamps, report);
+    }
     
-    while (std::getline(file, line)) {
-        std::stringstream ss(line);
-        std::string token;
-        OHLCV data;
-        
-        // Parse CSV: assuming format is Date,Open,High,Low,Close,Volume
-        // Skip date
-        std::getline(ss, token, ',');
-        
-        // Parse OHLCV
-        std::getline(ss, token, ',');
-        data.open = std::stod(token);
-        
-        std::getline(ss, token, ',');
-        data.high = std::stod(token);
-        
-        std::getline(ss, token, ',');
-        data.low = std::stod(token);
-        
-        std::getline(ss, token, ',');
-        data.close = std::stod(token);
-        
-        std::getline(ss, token, ',');
-        data.volume = std::stod(token);
-        
-        historical_data_.push_back(data);
+    if (data.empty()) {
+        std::cerr << "No data loaded from file" << std::endl;
+        return false;
+    }
+    if (!success) {
+        return false;
     }
     
-    file.close();
+    // Rolling-window indices refer to the previous history; train() restarts them
+    clearRollingWindows();
+    history_.assign(data);
+    timestamps_.swap(timestamps);
+    load_report_ = report;
+    STDS_COUNT(&metrics_, Counter::ROWS_LOADED, history_.size());
     
-    if (historical_data_.empty()) {
-        std::cerr << "No data loaded from file" << std::endl;
+    // Fit the normalizer to the data
+    STDS_TIME_STAGE(&metrics_, Stage::FIT);
+    normalizer_.fit(history_.closes());
+    
+    return true;
+}
+
+bool STDSEngine::setData(const std::vector<OHLCV>& data) {
+    if (data.empty()) {
         return false;
     }
     
+    clearRollingWindows();
+    history_.assign(data);
+    timestamps_.assign(data.size(), kNoTimestamp);
+    load_report_ = LoadReport();
+    load_report_.rows = data.size();
+    
     // Fit the normalizer to the data
-    normalizer_.fit(historical_data_);
+    STDS_TIME_STAGE(&metrics_, Stage::FIT);
+    normalizer_.fit(history_.closes());
     
     return true;
 }
 
 bool STDSEngine::checkProfitability(size_t start_index, bool is_buy) const {
-    if (start_index >= historical_data_.size()) {
+    const std::vector<double>& closes = history_.closes();
+    if (start_index >= closes.size()) {
         return false;
     }
     
-    double entry_price = historical_data_[start_index].close;
-    size_t end_index = std::min(start_index + config_.lookahead_days, historical_data_.size());
+    double entry_price = closes[start_index];
+    size_t end_index = std::min(start_index + config_.lookahead_days, closes.size());
     
     for (size_t i = start_index + 1; i < end_index; ++i) {
-        double current_price = historical_data_[i].close;
+        double current_price = closes[i];
         double return_pct = (current_price - entry_price) / entry_price;
         
         if (is_buy) {
@@ -94,26 +120,137 @@ bool STDSEngine::checkProfitability(size_t start_index, bool is_buy) const {
     return false;
 }
 
-void STDSEngine::train() {
-    if (historical_data_.size() < config_.sequence_length + config_.lookahead_days) {
-        std::cerr << "Not enough data for training" << std::endl;
-        return;
+void STDSEngine::insertWindow(const std::vector<int>& sequence, bool buy_signal, bool sell_signal) {
+    STDS_COUNT(&metrics_, Counter::WINDOWS_INSERTED, 1);
+    tree_.insertSequence(sequence, buy_signal, sell_signal);
+    if (fixed_tree_) {
+        fixed_tree_->insertSequence(sequence.data(), buy_signal, sell_signal);
     }
+}
+
+void STDSEngine::removeWindow(const std::vector<int>& sequence, bool buy_signal, bool sell_signal) {
+    STDS_COUNT(&metrics_, Counter::WINDOWS_EXPIRED, 1);
+    tree_.removeSequence(sequence, buy_signal, sell_signal);
+    if (fixed_tree_) {
+        fixed_tree_->removeSequence(sequence.data(), buy_signal, sell_signal);
+    }
+}
+
+std::vector<int> STDSEngine::windowAt(size_t data_index) const {
+    std::vector<int> sequence;
+    sequence.reserve(config_.sequence_length);
     
-    // Convert historical data to symbol sequence
+    for (size_t i = data_index - config_.sequence_length; i < data_index; ++i) {
+        double log_return = Normalizer::calculateLogReturn(
+            history_.close(i),
+            history_.close(i + 1)
+        );
+        sequence.push_back(normalizer_.transform(log_return));
+    }
+    
+    return sequence;
+}
+
+void STDSEngine::advanceRollingWindow() {
+    size_t size = history_.size();
+    size_t window = static_cast<size_t>(config_.rolling_window);
+    
+    // A window's labels are final once its whole lookahead has been observed
+    while (next_label_index_ + config_.lookahead_days <= size) {
+        size_t data_index = next_label_index_++;
+        if (data_index + window < size) {
+            continue;  // Already outside the trailing window
+        }
+        
+        LabeledWindow labeled;
+        labeled.data_index = data_index;
+        labeled.sequence = windowAt(data_index);
+        labeled.buy_signal = checkProfitability(data_index, true);
+        labeled.sell_signal = checkProfitability(data_index, false);
+        
+        insertWindow(labeled.sequence, labeled.buy_signal, labeled.sell_signal);
+        rolling_windows_.push_back(labeled);
+    }
+    
+    // Expire windows whose entry bar fell out of the trailing window
+    while (!rolling_windows_.empty() && rolling_windows_.front().data_index + window < size) {
+        const LabeledWindow& expired = rolling_windows_.front();
+        removeWindow(expired.sequence, expired.buy_signal, expired.sell_signal);
+        rolling_windows_.pop_front();
+    }
+}
+
+void STDSEngine::clearRollingWindows() {
+    // Windows leave the trees with the deque, or nothing could expire them later
+    for (const LabeledWindow& held : rolling_windows_) {
+        removeWindow(held.sequence, held.buy_signal, held.sell_signal);
+    }
+    rolling_windows_.clear();
+    rolling_active_ = false;
+}
+
+std::vector<int> STDSEngine::symbolize() const {
+    STDS_TIME_STAGE(&metrics_, Stage::SYMBOLIZE);
+    const std::vector<double>& closes = history_.closes();
     std::vector<int> symbols;
-    symbols.reserve(historical_data_.size());
+    if (closes.size() < 2) {
+        return symbols;
+    }
+    symbols.reserve(closes.size() - 1);
     
-    for (size_t i = 1; i < historical_data_.size(); ++i) {
+    for (size_t i = 1; i < closes.size(); ++i) {
         double log_return = Normalizer::calculateLogReturn(
-            historical_data_[i-1].close,
-            historical_data_[i].close
+            closes[i-1],
+            closes[i]
         );
-        int symbol = normalizer_.transform(log_return);
-        symbols.push_back(symbol);
+        symbols.push_back(normalizer_.transform(log_return));
     }
     
+    return symbols;
+}
+
+std::vector<uint8_t> STDSEngine::label() const {
+    STDS_TIME_STAGE(&metrics_, Stage::LABEL);
+    std::vector<uint8_t> labels(history_.size(), 0);
+    
+    for (size_t i = 0; i < history_.size(); ++i) {
+        if (checkProfitability(i, true)) {
+            labels[i] |= LABEL_BUY;
+        }
+        if (checkProfitability(i, false)) {
+            labels[i] |= LABEL_SELL;
+        }
+    }
+    
+    return labels;
+}
+
+void STDSEngine::train() {
+    if (history_.size() < static_cast<size_t>(config_.sequence_length + config_.lookahead_days)) {
+        std::cerr << "Not enough data for training" << std::endl;
+        return;
+    }
+    
+    if (config_.rolling_window > 0) {
+        size_t size = history_.size();
+        size_t window = static_cast<size_t>(config_.rolling_window);
+        next_label_index_ = std::max(static_cast<size_t>(config_.sequence_length),
+                                     size > window ? size - window : 0);
+        STDS_TIME_STAGE(&metrics_, Stage::INSERT);
+        clearRollingWindows();
+        rolling_active_ = true;
+        advanceRollingWindow();
+        return;
+    }
+    
+    // Convert historical data to symbol sequence
+    std::vector<int> symbols = symbolize();
+    
+    // Check profitability for buy and sell signals
+    std::vector<uint8_t> labels = label();
+    
     // Build sequences and insert into tree
+    STDS_TIME_STAGE(&metrics_, Stage::INSERT);
     for (size_t i = 0; i + config_.sequence_length < symbols.size(); ++i) {
         // Extract sequence
         std::vector<int> sequence(
@@ -121,27 +258,60 @@ void STDSEngine::train() {
             symbols.begin() + i + config_.sequence_length
         );
         
-        // Check profitability for buy and sell signals
         size_t data_index = i + config_.sequence_length;
-        bool buy_profitable = checkProfitability(data_index, true);
-        bool sell_profitable = checkProfitability(data_index, false);
+        bool buy_profitable = (labels[data_index] & LABEL_BUY) != 0;
+        bool sell_profitable = (labels[data_index] & LABEL_SELL) != 0;
         
         // Insert into tree
-        tree_.insertSequence(sequence, buy_profitable, sell_profitable);
+        insertWindow(sequence, buy_profitable, sell_profitable);
     }
 }
 
+bool STDSEngine::crossValidate(const CrossValidationOptions& options,
+                               CrossValidationReport& report) const {
+    if (history_.size() < static_cast<size_t>(config_.sequence_length + config_.lookahead_days)) {
+        std::cerr << "Not enough data for cross-validation" << std::endl;
+        return false;
+    }
+    
+    std::vector<int> symbols = symbolize();
+    std::vector<uint8_t> labels = label();
+    return makeCrossValidator().run(symbols, labels, options, report);
+}
+
+CrossValidator STDSEngine::makeCrossValidator() const {
+    CrossValidator validator(config_.num_bins, config_.sequence_length,
+                             config_.lookahead_days, config_.confidence_threshold);
+    if (config_.approximate_max_distance > 0) {
+        ApproximateQueryOptions approximate;
+        approximate.max_distance = config_.approximate_max_distance;
+        approximate.metric = config_.approximate_metric;
+        approximate.time_budget_us = config_.approximate_time_budget_us;
+        validator.setApproximateFallback(approximate);
+    }
+    validator.setUseFixedTree(config_.use_fixed_tree);
+    validator.setRollingWindow(config_.rolling_window);
+    return validator;
+}
+
 std::string STDSEngine::processNewData(const OHLCV& data) {
+    STDS_TIME_STAGE(&metrics_, Stage::TICK);
+    STDS_COUNT(&metrics_, Counter::TICKS, 1);
+    
     // Add to historical data
-    historical_data_.push_back(data);
+    history_.push_back(data);
     
     // Calculate symbol for new data
-    if (historical_data_.size() < 2) {
+    if (history_.size() < 2) {
         return "NONE";
     }
     
+    if (rolling_active_) {
+        advanceRollingWindow();
+    }
+    
     double log_return = Normalizer::calculateLogReturn(
-        historical_data_[historical_data_.size() - 2].close,
+        history_.close(history_.size() - 2),
         data.close
     );
     int symbol = normalizer_.transform(log_return);
@@ -156,10 +326,55 @@ std::string STDSEngine::processNewData(const OHLCV& data) {
     
     // Query the tree for decision
     if (symbol_sequence_.size() == static_cast<size_t>(config_.sequence_length)) {
-        return tree_.query(symbol_sequence_);
+        if (fixed_tree_) {
+            const char* decision = fixed_tree_->query(symbol_sequence_.data());
+            if (decision) {
+                return decision;
+            }
+        } else {
+            const SequenceNode* node = tree_.findNode(symbol_sequence_);
+            if (node) {
+                return node->synthesis;
+            }
+        }
+        
+        // Unseen window: fall back to the best-supported neighbouring pattern
+        if (config_.approximate_max_distance > 0) {
+            ApproximateQueryOptions options;
+            options.max_distance = config_.approximate_max_distance;
+            options.metric = config_.approximate_metric;
+            options.max_results = 1;
+            options.time_budget_us = config_.approximate_time_budget_us;
+            
+            ApproximateQueryResult result = tree_.queryApproximate(symbol_sequence_, options);
+            STDS_COUNT(&metrics_, Counter::APPROXIMATE_QUERIES, 1);
+            STDS_COUNT(&metrics_, Counter::APPROXIMATE_TIMEOUTS, result.timed_out ? 1 : 0);
+            if (!result.matches.empty()) {
+                return result.matches.front().node->synthesis;
+            }
+        }
     }
     
     return "NONE";
 }
 
+std::vector<RankedPattern> STDSEngine::getTopPatterns(size_t k, PatternSide side) const {
+    if (!pattern_index_) {
+        return std::vector<RankedPattern>();
+    }
+    return pattern_index_->top(k, side);
+}
+
+MetricsSnapshot STDSEngine::getMetrics() const {
+    MetricsSnapshot snapshot = metrics_.snapshot();
+    
+    snapshot.tree_nodes = tree_.getNodeCount();
+    snapshot.tree_bytes = tree_.getMemoryBytes();
+    snapshot.node_allocations = tree_.getNodeAllocations();
+    snapshot.history_bars = history_.size();
+    snapshot.history_bytes = history_.memoryBytes();
+    
+    return snapshot;
+}
+
 }  // namespace stds
@@ -1,37 +1,67 @@
 #include "SequenceTree.hpp"
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <queue>
+#include <random>
 
 namespace stds {
 
+namespace {
+
+/**
+ * @brief Next tree epoch: a random start per process, then one per tree
+ */
+uint64_t nextEpoch() {
+    static std::atomic<uint64_t> next([] {
+        std::random_device device;
+        return (static_cast<uint64_t>(device()) << 20) ^ device();
+    }());
+    return next++ & ((uint64_t(1) << 53) - 1);
+}
+
+}  // namespace
+
 SequenceTree::SequenceTree(double confidence_threshold)
-    : root_(new SequenceNode(0, -1)), next_id_(1), confidence_threshold_(confidence_threshold) {
+    : root_(new SequenceNode(0, -1, 0, &child_memory_)), next_id_(1), node_count_(1),
+      node_allocations_(1), confidence_threshold_(confidence_threshold), metrics_(nullptr),
+      pattern_index_(nullptr), epoch_(nextEpoch()), version_(0), journal_floor_(1),
+      delta_journal_(false),
+      journal_(TrackingAllocator<JournalEntry>(&journal_memory_)),
+      nodes_by_id_(0, std::hash<uint32_t>(), std::equal_to<uint32_t>(),
+                   TrackingAllocator<std::pair<const uint32_t, SequenceNode*>>(&index_memory_)) {
 }
 
 SequenceTree::~SequenceTree() {
     delete root_;
 }
 
-void SequenceTree::calculateSynthesis(SequenceNode* node) {
-    uint64_t total_visits = node->weight;
-    
-    if (total_visits == 0) {
-        node->synthesis = "NONE";
-        return;
+const char* SequenceTree::synthesize(uint64_t weight, const Stats& stats, double confidence_threshold) {
+    if (weight == 0) {
+        return "NONE";
     }
     
-    double buy_ratio = static_cast<double>(node->stats.buy_wins) / total_visits;
-    double sell_ratio = static_cast<double>(node->stats.sell_wins) / total_visits;
+    double buy_ratio = static_cast<double>(stats.buy_wins) / weight;
+    double sell_ratio = static_cast<double>(stats.sell_wins) / weight;
     
-    if (buy_ratio > confidence_threshold_) {
-        node->synthesis = "BUY";
-    } else if (sell_ratio > confidence_threshold_) {
-        node->synthesis = "SELL";
+    if (buy_ratio > confidence_threshold) {
+        return "BUY";
+    } else if (sell_ratio > confidence_threshold) {
+        return "SELL";
     } else if (buy_ratio > 0.4 || sell_ratio > 0.4) {
-        node->synthesis = "HOLD";
-    } else {
-        node->synthesis = "NONE";
+        return "HOLD";
     }
+    return "NONE";
+}
+
+void SequenceTree::calculateSynthesis(SequenceNode* node) {
+    if (metrics_) {
+        STDS_COUNT(metrics_, Counter::SYNTHESES, 1);
+    }
+    node->synthesis = synthesize(node->weight, node->stats, confidence_threshold_);
 }
 
 void SequenceTree::insertSequence(const std::vector<int>& sequence, bool buy_signal, bool sell_signal) {
@@ -40,6 +70,7 @@ void SequenceTree::insertSequence(const std::vector<int>& sequence, bool buy_sig
     }
     
     SequenceNode* current = root_;
+    ++version_;
     
     // Traverse or create path for the sequence
     for (int symbol : sequence) {
@@ -47,9 +78,14 @@ void SequenceTree::insertSequence(const std::vector<int>& sequence, bool buy_sig
         
         if (it == current->children.end()) {
             // Create new node
-            SequenceNode* new_node = new SequenceNode(next_id_++, symbol);
+            SequenceNode* new_node = new SequenceNode(next_id_++, symbol, current->id, &child_memory_);
             current->children[symbol] = new_node;
             current = new_node;
+            if (delta_journal_) {
+                nodes_by_id_[new_node->id] = new_node;
+            }
+            ++node_count_;
+            ++node_allocations_;
             
             // Notify callback if set
             if (node_callback_) {
@@ -61,6 +97,7 @@ void SequenceTree::insertSequence(const std::vector<int>& sequence, bool buy_sig
         
         // Update weight (frequency)
         current->weight++;
+        journalNode(current->id);
     }
     
     // Update statistics at the final node
@@ -76,6 +113,120 @@ void SequenceTree::insertSequence(const std::vector<int>& sequence, bool buy_sig
     
     // Recalculate synthesis
     calculateSynthesis(current);
+    if (pattern_index_) {
+        pattern_index_->update(sequence, current);
+    }
+    compactJournal();
+}
+
+bool SequenceTree::removeSequence(const std::vector<int>& sequence, bool buy_signal, bool sell_signal) {
+    if (sequence.empty()) {
+        return false;
+    }
+    
+    // Collect the path first so nothing is modified if the sequence is missing
+    std::vector<SequenceNode*> path;
+    path.reserve(sequence.size() + 1);
+    path.push_back(root_);
+    
+    for (int symbol : sequence) {
+        auto it = path.back()->children.find(symbol);
+        if (it == path.back()->children.end() || it->second->weight == 0) {
+            return false;
+        }
+        path.push_back(it->second);
+    }
+    
+    ++version_;
+    for (size_t i = 1; i < path.size(); ++i) {
+        path[i]->weight--;
+        journalNode(path[i]->id);
+    }
+    
+    // Undo the statistics at the final node
+    SequenceNode* last = path.back();
+    if (buy_signal && last->stats.buy_wins > 0) {
+        last->stats.buy_wins--;
+    }
+    if (sell_signal && last->stats.sell_wins > 0) {
+        last->stats.sell_wins--;
+    }
+    if (!buy_signal && !sell_signal && last->stats.hold_count > 0) {
+        last->stats.hold_count--;
+    }
+    
+    calculateSynthesis(last);
+    if (pattern_index_) {
+        pattern_index_->update(sequence, last);
+    }
+    
+    // Reclaim nodes without support, deepest first. A node's weight bounds the
+    // sum of its children's weights, so an unsupported node has no live children.
+    for (size_t i = path.size() - 1; i > 0 && path[i]->weight == 0; --i) {
+        path[i - 1]->children.erase(path[i]->symbol);
+        if (delta_journal_) {
+            nodes_by_id_.erase(path[i]->id);
+        }
+        if (pattern_index_) {
+            pattern_index_->erase(path[i]->id);
+        }
+        delete path[i];
+        --node_count_;
+    }
+    
+    compactJournal();
+    return true;
+}
+
+void SequenceTree::journalNode(uint32_t node_id) {
+    if (!delta_journal_) {
+        return;
+    }
+    JournalEntry entry = { version_, node_id };
+    journal_.push_back(entry);
+}
+
+void SequenceTree::setDeltaJournal(bool enabled) {
+    if (enabled == delta_journal_) {
+        return;
+    }
+    delta_journal_ = enabled;
+    
+    // Swapping with empty containers hands their storage back to the trackers
+    decltype(journal_)(journal_.get_allocator()).swap(journal_);
+    decltype(nodes_by_id_)(0, std::hash<uint32_t>(), std::equal_to<uint32_t>(),
+                           nodes_by_id_.get_allocator()).swap(nodes_by_id_);
+    
+    // Changes up to now are not journaled; older clients get a snapshot
+    journal_floor_ = version_ + 1;
+    if (!enabled) {
+        return;
+    }
+    
+    nodes_by_id_.reserve(node_count_);
+    std::vector<SequenceNode*> stack(1, root_);
+    while (!stack.empty()) {
+        SequenceNode* node = stack.back();
+        stack.pop_back();
+        nodes_by_id_[node->id] = node;
+        for (const auto& child : node->children) {
+            stack.push_back(child.second);
+        }
+    }
+}
+
+void SequenceTree::compactJournal() {
+    const size_t min_entries = 1 << 16;
+    if (journal_.size() <= std::max(min_entries, static_cast<size_t>(node_count_) * 4)) {
+        return;
+    }
+    
+    // Keep whole versions: cut at the first entry of the middle entry's version
+    uint64_t floor = journal_[journal_.size() / 2].version;
+    auto cut = std::lower_bound(journal_.begin(), journal_.end(), floor,
+        [](const JournalEntry& entry, uint64_t version) { return entry.version < version; });
+    journal_.erase(journal_.begin(), cut);
+    journal_floor_ = floor;
 }
 
 std::string SequenceTree::query(const std::vector<int>& sequence) const {
@@ -83,18 +234,169 @@ std::string SequenceTree::query(const std::vector<int>& sequence) const {
         return "NONE";
     }
     
+    const SequenceNode* node = findNode(sequence);
+    if (!node) {
+        return "NONE";  // Sequence not found
+    }
+    
+    return node->synthesis;
+}
+
+const SequenceNode* SequenceTree::findNode(const std::vector<int>& sequence) const {
     const SequenceNode* current = root_;
     
     // Traverse the tree following the sequence
     for (int symbol : sequence) {
         auto it = current->children.find(symbol);
         if (it == current->children.end()) {
-            return "NONE";  // Sequence not found
+            return nullptr;
         }
         current = it->second;
     }
     
-    return current->synthesis;
+    return current;
+}
+
+namespace {
+
+/**
+ * @brief Open node in the approximate search frontier
+ */
+struct SearchEntry {
+    const SequenceNode* node;
+    size_t depth;
+    int distance;
+    int parent;  // Index of the parent entry, -1 for the root
+};
+
+/**
+ * @brief Heap ordering: closest first, then deepest, then heaviest
+ *
+ * Shallow prefixes always outweigh the windows below them, so ordering by
+ * weight alone spends the time budget expanding prefixes. Diving along the
+ * closest paths reaches full-length windows first; their weights then prune
+ * every lighter subtree.
+ */
+struct SearchOrder {
+    const std::vector<SearchEntry>* entries;
+    
+    bool operator()(int a, int b) const {
+        const SearchEntry& ea = (*entries)[a];
+        const SearchEntry& eb = (*entries)[b];
+        if (ea.distance != eb.distance) {
+            return ea.distance > eb.distance;
+        }
+        if (ea.depth != eb.depth) {
+            return ea.depth < eb.depth;
+        }
+        return ea.node->weight < eb.node->weight;
+    }
+};
+
+/**
+ * @brief True if (weight, distance) ranks strictly better than the given match
+ */
+bool ranksBefore(uint64_t weight, int distance, const ApproximateMatch& match) {
+    if (weight != match.node->weight) {
+        return weight > match.node->weight;
+    }
+    return distance < match.distance;
+}
+
+}  // namespace
+
+ApproximateQueryResult SequenceTree::queryApproximate(const std::vector<int>& sequence,
+                                                      const ApproximateQueryOptions& options) const {
+    ApproximateQueryResult result;
+    if (sequence.empty() || options.max_distance < 0 || options.max_results == 0) {
+        return result;
+    }
+    
+    typedef std::chrono::steady_clock Clock;
+    const Clock::time_point deadline = Clock::now() + std::chrono::microseconds(options.time_budget_us);
+    
+    std::vector<SearchEntry> entries;
+    SearchOrder order = { &entries };
+    std::priority_queue<int, std::vector<int>, SearchOrder> frontier(order);
+    
+    SearchEntry root_entry = { root_, 0, 0, -1 };
+    entries.push_back(root_entry);
+    frontier.push(0);
+    
+    std::vector<ApproximateMatch>& matches = result.matches;
+    
+    while (!frontier.empty()) {
+        // Check the clock only every few expansions to keep the overhead low
+        if (options.time_budget_us > 0 && (result.nodes_visited & 31) == 31 &&
+            Clock::now() >= deadline) {
+            result.timed_out = true;
+            break;
+        }
+        
+        int index = frontier.top();
+        frontier.pop();
+        const SearchEntry entry = entries[index];
+        ++result.nodes_visited;
+        
+        // Matches found since this node was queued may have made it unable to
+        // improve the result set; weights never increase along a path
+        if (matches.size() == options.max_results &&
+            !ranksBefore(entry.node->weight, entry.distance, matches.back())) {
+            continue;
+        }
+        
+        if (entry.depth == sequence.size()) {
+            ApproximateMatch match;
+            match.sequence.resize(entry.depth);
+            for (int i = index; entries[i].parent >= 0; i = entries[i].parent) {
+                match.sequence[entries[i].depth - 1] = entries[i].node->symbol;
+            }
+            match.distance = entry.distance;
+            match.node = entry.node;
+            
+            auto pos = std::upper_bound(matches.begin(), matches.end(), match,
+                [](const ApproximateMatch& a, const ApproximateMatch& b) {
+                    return ranksBefore(a.node->weight, a.distance, b);
+                });
+            matches.insert(pos, match);
+            if (matches.size() > options.max_results) {
+                matches.pop_back();
+            }
+            continue;
+        }
+        
+        int target = sequence[entry.depth];
+        int remaining = options.max_distance - entry.distance;
+        const auto& children = entry.node->children;
+        
+        // For L1 only symbols within the remaining distance can match
+        auto first = children.begin();
+        auto last = children.end();
+        if (options.metric == DistanceMetric::L1 || remaining == 0) {
+            first = children.lower_bound(target - remaining);
+            last = children.upper_bound(target + remaining);
+        }
+        
+        for (auto it = first; it != last; ++it) {
+            int step = (options.metric == DistanceMetric::L1)
+                ? std::abs(it->first - target)
+                : (it->first == target ? 0 : 1);
+            int distance = entry.distance + step;
+            if (distance > options.max_distance) {
+                continue;
+            }
+            if (matches.size() == options.max_results &&
+                !ranksBefore(it->second->weight, distance, matches.back())) {
+                continue;
+            }
+            
+            SearchEntry child = { it->second, entry.depth + 1, distance, index };
+            entries.push_back(child);
+            frontier.push(static_cast<int>(entries.size() - 1));
+        }
+    }
+    
+    return result;
 }
 
 void SequenceTree::serializeNode(const SequenceNode* node, std::string& json, bool is_last) const {
@@ -126,10 +428,168 @@ void SequenceTree::serializeNode(const SequenceNode* node, std::string& json, bo
 }
 
 std::string SequenceTree::toJSON() const {
-    std::string json = "{\"root\":";
+    std::string json = "{\"epoch\":" + std::to_string(epoch_);
+    json += ",\"version\":" + std::to_string(version_) + ",\"root\":";
     serializeNode(root_, json, true);
     json += "}";
     return json;
 }
 
+namespace {
+
+/**
+ * @brief Append a node as a positional array in getDelta "fields" order
+ */
+void appendDeltaNode(const SequenceNode* node, std::string& json) {
+    json += "[" + std::to_string(node->id) + ",";
+    json += (node->id == 0 ? std::string("-1") : std::to_string(node->parent_id)) + ",";
+    json += std::to_string(node->symbol) + ",";
+    json += std::to_string(node->weight) + ",";
+    json += std::to_string(node->stats.buy_wins) + ",";
+    json += std::to_string(node->stats.sell_wins) + ",";
+    json += std::to_string(node->stats.hold_count) + ",";
+    json += "\"" + node->synthesis + "\"]";
+}
+
+}  // namespace
+
+std::string SequenceTree::getDelta(uint64_t since) const {
+    // A since ahead of version_ was issued by another tree instance
+    bool reset = !delta_journal_ || since == 0 || since > version_ || since + 1 < journal_floor_;
+    
+    std::string json = "{\"epoch\":" + std::to_string(epoch_);
+    json += ",\"version\":" + std::to_string(version_);
+    json += ",\"since\":" + std::to_string(since);
+    json += ",\"reset\":" + std::string(reset ? "true" : "false");
+    json += ",\"fields\":[\"id\",\"parent\",\"symbol\",\"weight\",";
+    json += "\"buy_wins\",\"sell_wins\",\"hold_count\",\"synthesis\"]";
+    json += ",\"nodes\":[";
+    
+    std::vector<uint32_t> removed;
+    bool first = true;
+    
+    if (reset) {
+        // Full snapshot in preorder so parents precede children
+        std::vector<const SequenceNode*> stack(1, root_);
+        while (!stack.empty()) {
+            const SequenceNode* node = stack.back();
+            stack.pop_back();
+            if (!first) {
+                json += ",";
+            }
+            appendDeltaNode(node, json);
+            first = false;
+            for (auto it = node->children.rbegin(); it != node->children.rend(); ++it) {
+                stack.push_back(it->second);
+            }
+        }
+    } else {
+        // Nodes touched after since; ids grow with creation, so sorting puts parents first
+        auto begin = std::upper_bound(journal_.begin(), journal_.end(), since,
+            [](uint64_t version, const JournalEntry& entry) { return version < entry.version; });
+        std::vector<uint32_t> ids;
+        ids.reserve(journal_.end() - begin);
+        for (auto it = begin; it != journal_.end(); ++it) {
+            ids.push_back(it->node_id);
+        }
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+        
+        for (uint32_t id : ids) {
+            auto found = nodes_by_id_.find(id);
+            if (found == nodes_by_id_.end()) {
+                removed.push_back(id);
+                continue;
+            }
+            if (!first) {
+                json += ",";
+            }
+            appendDeltaNode(found->second, json);
+            first = false;
+        }
+    }
+    
+    json += "],\"removed\":[";
+    for (size_t i = 0; i < removed.size(); ++i) {
+        if (i > 0) {
+            json += ",";
+        }
+        json += std::to_string(removed[i]);
+    }
+    json += "]}";
+    
+    return json;
+}
+
+uint64_t SequenceTree::getMemoryBytes() const {
+    return static_cast<uint64_t>(node_count_) * sizeof(SequenceNode) +
+           child_memory_.getLiveBytes() + index_memory_.getLiveBytes() +
+           journal_memory_.getLiveBytes();
+}
+
+TreeStats SequenceTree::getStats() const {
+    TreeStats stats;
+    
+    std::vector<std::pair<const SequenceNode*, size_t>> stack(1, std::make_pair(root_, size_t(0)));
+    while (!stack.empty()) {
+        const SequenceNode* node = stack.back().first;
+        size_t depth = stack.back().second;
+        stack.pop_back();
+        
+        ++stats.nodes;
+        if (stats.nodes_per_depth.size() <= depth) {
+            stats.nodes_per_depth.resize(depth + 1, 0);
+        }
+        ++stats.nodes_per_depth[depth];
+        
+        size_t fanout = node->children.size();
+        if (stats.branching.size() <= fanout) {
+            stats.branching.resize(fanout + 1, 0);
+        }
+        ++stats.branching[fanout];
+        if (fanout == 0) {
+            ++stats.leaves;
+        }
+        
+        if (node != root_) {
+            if (node->weight > 0) {
+                size_t bucket = 0;
+                for (uint64_t w = node->weight; w > 1; w >>= 1) {
+                    ++bucket;
+                }
+                if (stats.support_histogram.size() <= bucket) {
+                    stats.support_histogram.resize(bucket + 1, 0);
+                }
+                ++stats.support_histogram[bucket];
+            }
+            
+            if (node->synthesis == "BUY") {
+                ++stats.buy_nodes;
+            } else if (node->synthesis == "SELL") {
+                ++stats.sell_nodes;
+            } else if (node->synthesis == "HOLD") {
+                ++stats.hold_nodes;
+            } else {
+                ++stats.none_nodes;
+            }
+        }
+        
+        for (const auto& child : node->children) {
+            stack.push_back(std::make_pair(child.second, depth + 1));
+        }
+    }
+    
+    stats.max_depth = stats.nodes_per_depth.empty() ? 0 : stats.nodes_per_depth.size() - 1;
+    stats.node_bytes = stats.nodes * sizeof(SequenceNode);
+    stats.child_map_bytes = child_memory_.getLiveBytes();
+    stats.index_bytes = index_memory_.getLiveBytes();
+    stats.journal_bytes = journal_memory_.getLiveBytes();
+    stats.total_bytes = stats.node_bytes + stats.child_map_bytes + stats.index_bytes +
+                        stats.journal_bytes;
+    stats.peak_tracked_bytes = child_memory_.getPeakBytes() + index_memory_.getPeakBytes() +
+                               journal_memory_.getPeakBytes();
+    
+    return stats;
+}
+
 }  // namespace stds
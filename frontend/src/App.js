@@ -44,7 +44,7 @@ function App() {
 
     newSocket.on('trainComplete', (data) => {
       console.log('Training complete:', data);
-      setTreeData(data.tree);
+      setTreeData(JSON.parse(data.tree));
       setStatus('trained');
     });
 
@@ -62,6 +62,10 @@ function App() {
       setDecisions(prev => [...prev, data]);
     });
 
+    newSocket.on('TICK_REJECTED', (rejection) => {
+      console.warn('Tick rejected:', rejection);
+    });
+
     newSocket.on('error', (error) => {
       console.error('Server error:', error);
       alert(`Error: ${error.message}`);
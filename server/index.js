@@ -22,6 +22,60 @@ app.use(express.static(path.join(__dirname, '../frontend/build')));
 // Global STDS engine instance
 let engine = null;
 
+const DEFAULT_CONFIG = {
+    numBins: 10,
+    sequenceLength: 5,
+    confidenceThreshold: 0.70,
+    lookaheadDays: 5,
+    takeProfitThreshold: 0.02
+};
+
+// Ticks handed to the current engine's thread, by sequence number. Each engine
+// numbers its ticks from 0 and gets its own map, so batches a replaced engine
+// had already queued cannot answer the new engine's ticks
+let pendingTicks = new Map();
+
+// Decisions arrive in batches from the engine thread, in tick order
+function deliverDecisions(ticks, batch) {
+    batch.forEach(({ seq, decision, latencyNs }) => {
+        const pending = ticks.get(seq);
+        if (!pending) {
+            return;
+        }
+        ticks.delete(seq);
+        pending.socket.emit('DECISION_TRIGGERED', {
+            seq,
+            id: pending.id,
+            decision,
+            data: pending.data,
+            timestamp: pending.timestamp,
+            latencyNs
+        });
+    });
+}
+
+// Create the engine and start its native tick-processing thread
+function createEngine(config) {
+    if (engine) {
+        engine.stopEngineThread();
+    }
+    const pending = new Map();
+    pendingTicks = pending;
+
+    engine = new STDSEngine(config || DEFAULT_CONFIG);
+    engine.startEngineThread((batch) => deliverDecisions(pending, batch));
+    return engine;
+}
+
+// Resolve { filename } (a CSV file or a directory of CSV files) or
+// { filenames: [...] } relative to the data directory
+function resolveDataPath({ filename, filenames }) {
+    if (Array.isArray(filenames)) {
+        return filenames.map((name) => path.join(__dirname, '../data', name));
+    }
+    return path.join(__dirname, '../data', filename);
+}
+
 // Socket.io connection handler
 io.on('connection', (socket) => {
     console.log('Client connected:', socket.id);
@@ -32,13 +86,7 @@ io.on('connection', (socket) => {
             console.log('Initializing engine with config:', config);
             
             // Create new engine with configuration
-            engine = new STDSEngine(config || {
-                numBins: 10,
-                sequenceLength: 5,
-                confidenceThreshold: 0.70,
-                lookaheadDays: 5,
-                takeProfitThreshold: 0.02
-            });
+            createEngine(config);
 
             // Set node callback for real-time updates
             engine.setNodeCallback((node) => {
@@ -65,14 +113,13 @@ io.on('connection', (socket) => {
                 throw new Error('Engine not initialized');
             }
 
-            const { filename } = data;
-            const dataPath = path.join(__dirname, '../data', filename);
+            const dataPath = resolveDataPath(data);
             
             console.log('Loading data from:', dataPath);
             const success = engine.loadData(dataPath);
 
             if (success) {
-                socket.emit('dataLoaded', { success: true });
+                socket.emit('dataLoaded', { success: true, report: engine.getLoadReport() });
             } else {
                 throw new Error('Failed to load data');
             }
@@ -95,9 +142,12 @@ io.on('connection', (socket) => {
             // Get tree JSON
             const treeJSON = engine.getTreeJSON();
             
+            // The tree goes out as the native JSON string; clients parse it once
             socket.emit('trainComplete', { 
                 success: true,
-                tree: JSON.parse(treeJSON)
+                epoch: engine.getTreeEpoch(),
+                version: engine.getTreeVersion(),
+                tree: treeJSON
             });
         } catch (error) {
             console.error('Training error:', error);
@@ -112,14 +162,17 @@ io.on('connection', (socket) => {
                 throw new Error('Engine not initialized');
             }
 
-            const { open, high, low, close, volume } = data;
-            const decision = engine.processNewData({ open, high, low, close, volume });
+            // Only enqueue here; the engine thread answers through deliverDecisions.
+            // The optional client id is echoed so either answer names its tick
+            const { id, open, high, low, close, volume } = data;
+            const tick = { open, high, low, close, volume };
+            const seq = engine.enqueueTick(tick);
+            if (seq === null) {
+                socket.emit('TICK_REJECTED', { id, data: tick, reason: 'Tick queue full' });
+                return;
+            }
 
-            socket.emit('DECISION_TRIGGERED', {
-                decision,
-                data: { open, high, low, close, volume },
-                timestamp: Date.now()
-            });
+            pendingTicks.set(seq, { socket, id, data: tick, timestamp: Date.now() });
         } catch (error) {
             console.error('Process data error:', error);
             socket.emit('error', { message: error.message });
@@ -141,6 +194,21 @@ io.on('connection', (socket) => {
         }
     });
 
+    // Get nodes changed since a tree version; reset=true means a full snapshot
+    socket.on('getTreeDelta', (request) => {
+        try {
+            if (!engine) {
+                throw new Error('Engine not initialized');
+            }
+
+            const since = request && Number.isFinite(request.since) ? request.since : 0;
+            socket.emit('treeDelta', JSON.parse(engine.getTreeDelta(since)));
+        } catch (error) {
+            console.error('Get tree delta error:', error);
+            socket.emit('error', { message: error.message });
+        }
+    });
+
     socket.on('disconnect', () => {
         console.log('Client disconnected:', socket.id);
     });
@@ -151,17 +219,70 @@ app.get('/api/health', (req, res) => {
     res.json({ status: 'ok', timestamp: Date.now() });
 });
 
+// Prometheus text exposition of the engine metrics
+function formatMetrics(metrics) {
+    const lines = [];
+    const metric = (name, type, help, samples) => {
+        lines.push(`# HELP ${name} ${help}`);
+        lines.push(`# TYPE ${name} ${type}`);
+        samples.forEach(([labels, value]) => lines.push(`${name}${labels} ${value}`));
+    };
+
+    const stages = Object.entries(metrics.stages);
+    metric('stds_stage_calls_total', 'counter', 'Calls per engine stage',
+        stages.map(([stage, s]) => [`{stage="${stage}"}`, s.calls]));
+    metric('stds_stage_seconds_total', 'counter', 'Time spent per engine stage',
+        stages.map(([stage, s]) => [`{stage="${stage}"}`, s.totalNs / 1e9]));
+    metric('stds_stage_max_seconds', 'gauge', 'Longest single call per engine stage',
+        stages.map(([stage, s]) => [`{stage="${stage}"}`, s.maxNs / 1e9]));
+
+    Object.entries(metrics.counters).forEach(([name, value]) => {
+        const snake = name.replace(/[A-Z]/g, (c) => `_${c.toLowerCase()}`);
+        metric(`stds_${snake}_total`, 'counter', `Engine counter ${name}`, [['', value]]);
+    });
+
+    const tick = metrics.tickLatency;
+    metric('stds_tick_latency_seconds', 'summary', 'processNewData latency', [
+        ['{quantile="0.5"}', tick.p50Ns / 1e9],
+        ['{quantile="0.99"}', tick.p99Ns / 1e9],
+        ['{quantile="0.999"}', tick.p999Ns / 1e9]
+    ]);
+    lines.push(`stds_tick_latency_seconds_count ${tick.count}`);
+    lines.push(`stds_tick_latency_seconds_sum ${metrics.stages.tick.totalNs / 1e9}`);
+
+    metric('stds_tree_nodes', 'gauge', 'Live nodes in the sequence tree', [['', metrics.tree.nodes]]);
+    metric('stds_tree_bytes', 'gauge', 'Sequence tree memory', [['', metrics.tree.bytes]]);
+    metric('stds_tree_node_allocations_total', 'counter', 'Nodes allocated', [['', metrics.tree.allocations]]);
+    metric('stds_history_bars', 'gauge', 'Bars held in price history', [['', metrics.history.bars]]);
+    metric('stds_history_bytes', 'gauge', 'Price history column memory', [['', metrics.history.bytes]]);
+
+    return lines.join('\n') + '\n';
+}
+
+app.get('/metrics', (req, res) => {
+    if (!engine) {
+        res.status(503).type('text/plain').send('# engine not initialized\n');
+        return;
+    }
+    res.type('text/plain; version=0.0.4').send(formatMetrics(engine.getMetrics()));
+});
+
+app.get('/api/metrics', (req, res) => {
+    try {
+        if (!engine) {
+            throw new Error('Engine not initialized');
+        }
+        res.json(engine.getMetrics());
+    } catch (error) {
+        res.status(500).json({ error: error.message });
+    }
+});
+
 app.post('/api/initialize', (req, res) => {
     try {
         const config = req.body;
         
-        engine = new STDSEngine(config || {
-            numBins: 10,
-            sequenceLength: 5,
-            confidenceThreshold: 0.70,
-            lookaheadDays: 5,
-            takeProfitThreshold: 0.02
-        });
+        createEngine(config);
 
         res.json({ success: true });
     } catch (error) {
@@ -175,13 +296,12 @@ app.post('/api/load', (req, res) => {
             throw new Error('Engine not initialized');
         }
 
-        const { filename } = req.body;
-        const dataPath = path.join(__dirname, '../data', filename);
+        const dataPath = resolveDataPath(req.body);
         
         const success = engine.loadData(dataPath);
 
         if (success) {
-            res.json({ success: true });
+            res.json({ success: true, report: engine.getLoadReport() });
         } else {
             throw new Error('Failed to load data');
         }
@@ -199,10 +319,21 @@ app.post('/api/train', (req, res) => {
         engine.train();
         const treeJSON = engine.getTreeJSON();
         
-        res.json({ 
-            success: true,
-            tree: JSON.parse(treeJSON)
-        });
+        // Splice the native JSON in directly instead of parsing and re-serializing it
+        res.type('json').send(`{"success":true,"tree":${treeJSON}}`);
+    } catch (error) {
+        res.status(500).json({ error: error.message });
+    }
+});
+
+app.post('/api/crossvalidate', (req, res) => {
+    try {
+        if (!engine) {
+            throw new Error('Engine not initialized');
+        }
+
+        const { folds, embargo, threads } = req.body || {};
+        res.json(engine.crossValidate({ folds: folds || 5, embargo: embargo || 0, threads: threads || 0 }));
     } catch (error) {
         res.status(500).json({ error: error.message });
     }
@@ -214,8 +345,46 @@ app.get('/api/tree', (req, res) => {
             throw new Error('Engine not initialized');
         }
 
-        const treeJSON = engine.getTreeJSON();
-        res.json(JSON.parse(treeJSON));
+        res.type('json').send(engine.getTreeJSON());
+    } catch (error) {
+        res.status(500).json({ error: error.message });
+    }
+});
+
+app.get('/api/tree/stats', (req, res) => {
+    try {
+        if (!engine) {
+            throw new Error('Engine not initialized');
+        }
+
+        res.json(engine.getTreeStats());
+    } catch (error) {
+        res.status(500).json({ error: error.message });
+    }
+});
+
+app.get('/api/patterns', (req, res) => {
+    try {
+        if (!engine) {
+            throw new Error('Engine not initialized');
+        }
+
+        const k = Number.parseInt(req.query.k, 10);
+        const side = typeof req.query.side === 'string' ? req.query.side.toUpperCase() : 'BOTH';
+        res.json(engine.getTopPatterns(Number.isNaN(k) ? 10 : k, side));
+    } catch (error) {
+        res.status(500).json({ error: error.message });
+    }
+});
+
+app.get('/api/tree/delta', (req, res) => {
+    try {
+        if (!engine) {
+            throw new Error('Engine not initialized');
+        }
+
+        const since = Number.parseInt(req.query.since, 10);
+        res.type('json').send(engine.getTreeDelta(Number.isNaN(since) ? 0 : since));
     } catch (error) {
         res.status(500).json({ error: error.message });
     }
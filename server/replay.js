@@ -0,0 +1,210 @@
+// Tick replay harness: streams a recorded OHLCV file through the engine at a
+// multiple of real time (or as fast as possible) and reports throughput,
+// latency percentiles and the decision stream.
+//
+//   node replay.js --train sample.csv --replay sample.csv [--speed N|max]
+//                  [--mode binding|socket] [--url http://localhost:3001]
+//                  [--decisions out.csv]
+//
+// --mode binding calls the N-API binding in-process; --mode socket drives a
+// running local server through the Socket.io processData path. Paths are
+// relative to the data directory, as with the server's loadData.
+
+const fs = require('fs');
+const path = require('path');
+
+const DATA_DIR = path.join(__dirname, '../data');
+
+function parseArgs(argv) {
+    const options = {
+        mode: 'binding',
+        speed: 0,
+        intervalMs: 1000,
+        url: 'http://localhost:3001',
+        config: {}
+    };
+    for (let i = 0; i < argv.length; i += 2) {
+        const [arg, value] = [argv[i], argv[i + 1]];
+        switch (arg) {
+            case '--train': options.train = value; break;
+            case '--replay': options.replay = value; break;
+            case '--speed': options.speed = value === 'max' ? 0 : Number(value); break;
+            case '--interval-ms': options.intervalMs = Number(value); break;
+            case '--mode': options.mode = value; break;
+            case '--url': options.url = value; break;
+            case '--decisions': options.decisions = value; break;
+            case '--config': options.config = JSON.parse(value); break;
+            default: throw new Error(`Unknown option ${arg}`);
+        }
+    }
+    if (!options.train || !options.replay) {
+        throw new Error('--train and --replay are required');
+    }
+    return options;
+}
+
+// Read Date,Open,High,Low,Close,Volume rows
+function readTicks(file) {
+    const lines = fs.readFileSync(path.join(DATA_DIR, file), 'utf8').split(/\r?\n/).slice(1);
+    return lines.filter((line) => line.trim() !== '').map((line) => {
+        const [date, open, high, low, close, volume] = line.split(',');
+        return {
+            time: Date.parse(date.includes(':') ? date.replace(' ', 'T') + 'Z' : date + 'T00:00:00Z'),
+            bar: { open: +open, high: +high, low: +low, close: +close, volume: +volume }
+        };
+    });
+}
+
+// Wall-clock arrival offsets in ms relative to the first tick
+function arrivalOffsets(ticks, options) {
+    if (options.speed <= 0) {
+        return ticks.map(() => 0);
+    }
+    const dated = ticks.every((tick) => !Number.isNaN(tick.time));
+    return ticks.map((tick, i) => {
+        const realMs = dated ? tick.time - ticks[0].time : i * options.intervalMs;
+        return realMs / options.speed;
+    });
+}
+
+const nowNs = () => process.hrtime.bigint();
+
+function percentile(sorted, q) {
+    if (sorted.length === 0) {
+        return 0;
+    }
+    const rank = Math.min(Math.max(Math.round(q * sorted.length), 1), sorted.length);
+    return sorted[rank - 1];
+}
+
+function waitUntil(startNs, offsetMs) {
+    const delayMs = Number(startNs + BigInt(Math.round(offsetMs * 1e6)) - nowNs()) / 1e6;
+    return delayMs > 1 ? new Promise((resolve) => setTimeout(resolve, delayMs)) : Promise.resolve();
+}
+
+async function replayBinding(ticks, offsets, options) {
+    const { STDSEngine } = require('../bindings/build/Release/stds_bindings.node');
+    const engine = new STDSEngine(options.config);
+    if (!engine.loadData(path.join(DATA_DIR, options.train))) {
+        throw new Error('Failed to load training data');
+    }
+    engine.train();
+
+    const decisions = new Array(ticks.length);
+    const latencies = new Array(ticks.length);
+    const start = nowNs();
+    for (let i = 0; i < ticks.length; ++i) {
+        if (options.speed > 0) {
+            await waitUntil(start, offsets[i]);
+        }
+        const scheduled = options.speed > 0 ? start + BigInt(Math.round(offsets[i] * 1e6)) : nowNs();
+        decisions[i] = engine.processNewData(ticks[i].bar);
+        latencies[i] = Number(nowNs() - scheduled);
+    }
+    return { decisions, latencies, elapsedNs: Number(nowNs() - start) };
+}
+
+function replaySocket(ticks, offsets, options) {
+    const io = require('socket.io-client');
+    const socket = io(options.url, { transports: ['websocket'] });
+
+    const once = (event) => new Promise((resolve, reject) => {
+        socket.once(event, resolve);
+        socket.once('error', (error) => reject(new Error(error.message)));
+    });
+
+    return (async () => {
+        await once('connect');
+        socket.emit('initialize', options.config);
+        await once('initialized');
+        socket.emit('loadData', { filename: options.train });
+        await once('dataLoaded');
+        socket.emit('train');
+        await once('trainComplete');
+
+        // Each tick carries its index as id; the server echoes it on the decision,
+        // or on a rejection when the engine queue is full
+        const decisions = new Array(ticks.length);
+        const latencies = new Array(ticks.length);
+        const sent = new Array(ticks.length);
+        let answered = 0;
+        let rejected = 0;
+        const done = new Promise((resolve) => {
+            const settle = () => {
+                if (++answered === ticks.length) {
+                    resolve();
+                }
+            };
+            socket.on('DECISION_TRIGGERED', ({ id, decision }) => {
+                latencies[id] = Number(nowNs() - sent[id]);
+                decisions[id] = decision;
+                settle();
+            });
+            socket.on('TICK_REJECTED', ({ id }) => {
+                decisions[id] = 'REJECTED';
+                ++rejected;
+                settle();
+            });
+        });
+
+        const start = nowNs();
+        for (let i = 0; i < ticks.length; ++i) {
+            if (options.speed > 0) {
+                await waitUntil(start, offsets[i]);
+                sent[i] = start + BigInt(Math.round(offsets[i] * 1e6));
+            } else {
+                sent[i] = nowNs();
+            }
+            socket.emit('processData', { id: i, ...ticks[i].bar });
+        }
+        await done;
+        const elapsedNs = Number(nowNs() - start);
+        socket.close();
+        const answeredLatencies = latencies.filter((latency) => latency !== undefined);
+        return { decisions, latencies: answeredLatencies, elapsedNs, rejected };
+    })();
+}
+
+async function main() {
+    const options = parseArgs(process.argv.slice(2));
+    const ticks = readTicks(options.replay);
+    const offsets = arrivalOffsets(ticks, options);
+
+    const run = options.mode === 'socket' ? replaySocket : replayBinding;
+    const { decisions, latencies, elapsedNs, rejected = 0 } = await run(ticks, offsets, options);
+
+    if (options.decisions) {
+        const rows = decisions.map((decision, i) =>
+            `${i},${Number.isNaN(ticks[i].time) ? 0 : ticks[i].time / 1000},${ticks[i].bar.close},${decision}`);
+        fs.writeFileSync(options.decisions, ['index,timestamp,close,decision', ...rows].join('\n') + '\n');
+    }
+
+    const sorted = latencies.slice().sort((a, b) => a - b);
+    const counts = { BUY: 0, SELL: 0, HOLD: 0, NONE: 0 };
+    decisions.forEach((decision) => {
+        if (decision !== 'REJECTED') {
+            counts[decision] = (counts[decision] || 0) + 1;
+        }
+    });
+
+    console.log(JSON.stringify({
+        mode: options.mode,
+        ticks: ticks.length,
+        speed: options.speed > 0 ? options.speed : 'max',
+        elapsed_s: elapsedNs / 1e9,
+        throughput_per_s: elapsedNs > 0 ? ticks.length / (elapsedNs / 1e9) : 0,
+        latency_ns: {
+            p50: percentile(sorted, 0.50),
+            p99: percentile(sorted, 0.99),
+            p999: percentile(sorted, 0.999),
+            max: sorted.length ? sorted[sorted.length - 1] : 0
+        },
+        decisions: counts,
+        rejected
+    }));
+}
+
+main().catch((error) => {
+    console.error(error.message);
+    process.exit(1);
+});
@@ -1,12 +1,59 @@
 #include <gtest/gtest.h>
+#include "DataLoader.hpp"
+#include "FixedSequenceTree.hpp"
+#include "Metrics.hpp"
+#include "SpscRing.hpp"
 #include "Normalizer.hpp"
+#include "PatternIndex.hpp"
 #include "SequenceTree.hpp"
 #include "STDSEngine.hpp"
 #include <vector>
+#include <algorithm>
 #include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
 
 using namespace stds;
 
+// Temporary files written by writeSampleCSV
+static std::vector<std::string>& sampleFiles() {
+    static std::vector<std::string> files;
+    return files;
+}
+
+// Removes every sample file once all tests have run
+class SampleFileCleanup : public ::testing::Environment {
+public:
+    void TearDown() override {
+        for (const auto& path : sampleFiles()) {
+            std::remove(path.c_str());
+        }
+        sampleFiles().clear();
+    }
+};
+
+// Write a deterministic zig-zag OHLCV series to a temporary CSV file
+static std::string writeSampleCSV(const std::string& name, int rows) {
+    std::string path = "/tmp/stds_" + name + ".csv";
+    if (std::find(sampleFiles().begin(), sampleFiles().end(), path) == sampleFiles().end()) {
+        sampleFiles().push_back(path);
+    }
+    std::ofstream out(path.c_str());
+    out << "Date,Open,High,Low,Close,Volume\n";
+    double close = 100.0;
+    for (int i = 0; i < rows; ++i) {
+        double step = ((i * 7) % 11 - 5) * 0.006;
+        double open = close;
+        close = close * (1.0 + step);
+        out << (1704067200 + i * 86400) << "," << open << "," << close * 1.01 << ","
+            << close * 0.99 << "," << close << ",1000000\n";
+    }
+    return path;
+}
+
 // Test Normalizer
 TEST(NormalizerTest, CalculateLogReturn) {
     double prev_close = 100.0;
@@ -114,6 +161,429 @@ TEST(SequenceTreeTest, ConfidenceThreshold) {
     EXPECT_NE(decision, "BUY");
 }
 
+TEST(SequenceTreeTest, ApproximateQueryFindsNeighbour) {
+    SequenceTree tree(0.70);
+    
+    std::vector<int> stored = {4, 5, 5, 6, 4};
+    for (int i = 0; i < 5; ++i) {
+        tree.insertSequence(stored, true, false);
+    }
+    tree.insertSequence({4, 5, 8, 6, 4}, false, true);
+    
+    std::vector<int> live = {4, 5, 6, 6, 4};
+    EXPECT_EQ(tree.query(live), "NONE");
+    
+    ApproximateQueryOptions options;
+    options.max_distance = 1;
+    options.max_results = 5;
+    ApproximateQueryResult result = tree.queryApproximate(live, options);
+    
+    // {4,5,8,6,4} is two bins away and must be pruned
+    ASSERT_EQ(result.matches.size(), 1u);
+    EXPECT_EQ(result.matches[0].sequence, stored);
+    EXPECT_EQ(result.matches[0].distance, 1);
+    EXPECT_EQ(result.matches[0].node->synthesis, "BUY");
+    EXPECT_FALSE(result.timed_out);
+}
+
+TEST(SequenceTreeTest, ApproximateQueryRanksBySupport) {
+    SequenceTree tree(0.70);
+    
+    for (int i = 0; i < 3; ++i) {
+        tree.insertSequence({1, 2, 3}, true, false);
+    }
+    for (int i = 0; i < 7; ++i) {
+        tree.insertSequence({1, 9, 3}, false, true);
+    }
+    tree.insertSequence({1, 2, 4}, false, false);
+    
+    ApproximateQueryOptions options;
+    options.metric = DistanceMetric::HAMMING;
+    options.max_distance = 1;
+    options.max_results = 2;
+    ApproximateQueryResult result = tree.queryApproximate({1, 2, 3}, options);
+    
+    ASSERT_EQ(result.matches.size(), 2u);
+    EXPECT_EQ(result.matches[0].sequence, std::vector<int>({1, 9, 3}));
+    EXPECT_EQ(result.matches[0].node->weight, 7u);
+    EXPECT_EQ(result.matches[1].sequence, std::vector<int>({1, 2, 3}));
+    EXPECT_EQ(result.matches[1].distance, 0);
+}
+
+TEST(SequenceTreeTest, ApproximateQueryReachesNearWindowsWithinBudget) {
+    // A dense tree whose shallow prefixes far outweigh any full-length window
+    SequenceTree tree(0.70);
+    std::mt19937 rng(11);
+    std::normal_distribution<double> returns(4.5, 2.0);
+    std::vector<std::vector<int>> stored;
+    for (int i = 0; i < 200000; ++i) {
+        std::vector<int> window(5);
+        for (int& symbol : window) {
+            symbol = std::min(9, std::max(0, static_cast<int>(std::lround(returns(rng)))));
+        }
+        tree.insertSequence(window, (i & 1) != 0, false);
+        if (i % 1000 == 0) {
+            stored.push_back(window);
+        }
+    }
+    
+    for (DistanceMetric metric : {DistanceMetric::HAMMING, DistanceMetric::L1}) {
+        ApproximateQueryOptions options;  // Default 200 us budget
+        options.metric = metric;
+        options.max_distance = metric == DistanceMetric::L1 ? 10 : 3;
+        
+        for (std::vector<int> window : stored) {
+            window[2] = (window[2] + 5) % 10;
+            ApproximateQueryResult result = tree.queryApproximate(window, options);
+            EXPECT_FALSE(result.matches.empty());
+        }
+    }
+}
+
+TEST(SequenceTreeTest, RemoveSequenceReclaimsNodes) {
+    SequenceTree tree(0.70);
+    
+    tree.insertSequence({1, 2, 3}, true, false);
+    tree.insertSequence({1, 2, 4}, false, true);
+    EXPECT_EQ(tree.getNodeCount(), 5u);
+    
+    EXPECT_TRUE(tree.removeSequence({1, 2, 4}, false, true));
+    EXPECT_EQ(tree.getNodeCount(), 4u);
+    EXPECT_EQ(tree.findNode({1, 2, 4}), nullptr);
+    EXPECT_EQ(tree.findNode({1, 2})->weight, 1u);
+    EXPECT_EQ(tree.query({1, 2, 3}), "BUY");
+    
+    EXPECT_FALSE(tree.removeSequence({7, 7, 7}, true, false));
+    EXPECT_TRUE(tree.removeSequence({1, 2, 3}, true, false));
+    EXPECT_EQ(tree.getNodeCount(), 1u);
+    EXPECT_TRUE(tree.getRoot()->children.empty());
+}
+
+TEST(SequenceTreeTest, StatsDescribeShapeAndMemory) {
+    SequenceTree tree(0.70);
+    
+    tree.insertSequence({1, 2, 3}, true, false);
+    tree.insertSequence({1, 2, 3}, true, false);
+    tree.insertSequence({1, 2, 4}, false, true);
+    tree.insertSequence({5, 6, 7}, false, false);
+    
+    TreeStats stats = tree.getStats();
+    EXPECT_EQ(stats.nodes, tree.getNodeCount());
+    EXPECT_EQ(stats.leaves, 3u);
+    EXPECT_EQ(stats.max_depth, 3u);
+    EXPECT_EQ(stats.nodes_per_depth, (std::vector<uint64_t>{1, 2, 2, 3}));
+    EXPECT_EQ(stats.branching, (std::vector<uint64_t>{3, 3, 2}));
+    
+    // Weights: {1}=3, {1,2}=3, {1,2,3}=2, {1,2,4}=1, {5}=1, {5,6}=1, {5,6,7}=1
+    EXPECT_EQ(stats.support_histogram, (std::vector<uint64_t>{4, 3}));
+    EXPECT_EQ(stats.buy_nodes, 1u);
+    EXPECT_EQ(stats.sell_nodes, 1u);
+    EXPECT_EQ(stats.buy_nodes + stats.sell_nodes + stats.hold_nodes + stats.none_nodes,
+              stats.nodes - 1);
+    
+    EXPECT_GT(stats.child_map_bytes, 0u);
+    EXPECT_EQ(stats.total_bytes, tree.getMemoryBytes());
+    
+    // Reclaimed nodes hand their child map entries back to the tracker
+    EXPECT_TRUE(tree.removeSequence({5, 6, 7}, false, false));
+    TreeStats after = tree.getStats();
+    EXPECT_LT(after.child_map_bytes, stats.child_map_bytes);
+    EXPECT_GE(after.peak_tracked_bytes, stats.child_map_bytes);
+}
+
+TEST(SequenceTreeTest, DeltaReportsChangedAndRemovedNodes) {
+    SequenceTree tree(0.70);
+    tree.setDeltaJournal(true);
+    EXPECT_EQ(tree.getVersion(), 0u);
+    
+    tree.insertSequence({1, 2, 3}, true, false);
+    tree.insertSequence({1, 2, 4}, false, true);
+    EXPECT_EQ(tree.getVersion(), 2u);
+    
+    // Only the second insertion's path, parents first
+    std::string delta = tree.getDelta(1);
+    EXPECT_NE(delta.find("\"version\":2"), std::string::npos);
+    EXPECT_NE(delta.find("\"reset\":false"), std::string::npos);
+    EXPECT_NE(delta.find("\"nodes\":[[1,0,1,2,"), std::string::npos);
+    EXPECT_NE(delta.find("],[2,1,2,2,"), std::string::npos);
+    EXPECT_NE(delta.find("],[4,2,4,1,0,1,0,"), std::string::npos);
+    EXPECT_EQ(delta.find("[3,"), std::string::npos);
+    EXPECT_NE(delta.find("\"removed\":[]"), std::string::npos);
+    
+    EXPECT_TRUE(tree.removeSequence({1, 2, 4}, false, true));
+    delta = tree.getDelta(2);
+    EXPECT_NE(delta.find("\"nodes\":[[1,0,1,1,"), std::string::npos);
+    EXPECT_NE(delta.find("\"removed\":[4]"), std::string::npos);
+    
+    // Up to date clients get an empty delta
+    delta = tree.getDelta(tree.getVersion());
+    EXPECT_NE(delta.find("\"nodes\":[],\"removed\":[]"), std::string::npos);
+}
+
+TEST(SequenceTreeTest, DeltaJournalIsOptIn) {
+    SequenceTree tree(0.70);
+    EXPECT_FALSE(tree.hasDeltaJournal());
+    tree.insertSequence({1, 2, 3}, true, false);
+    tree.insertSequence({1, 2, 4}, false, true);
+    
+    // Nothing is journaled or indexed, and every delta is a full snapshot
+    TreeStats stats = tree.getStats();
+    EXPECT_EQ(stats.index_bytes, 0u);
+    EXPECT_EQ(stats.journal_bytes, 0u);
+    EXPECT_NE(tree.getDelta(1).find("\"reset\":true"), std::string::npos);
+    EXPECT_NE(tree.getDelta(2).find("\"reset\":true"), std::string::npos);
+    
+    // Enabling starts the journal at the current version
+    tree.setDeltaJournal(true);
+    EXPECT_NE(tree.getDelta(1).find("\"reset\":true"), std::string::npos);
+    EXPECT_NE(tree.getDelta(2).find("\"nodes\":[],\"removed\":[]"), std::string::npos);
+    EXPECT_TRUE(tree.removeSequence({1, 2, 4}, false, true));
+    std::string delta = tree.getDelta(2);
+    EXPECT_NE(delta.find("\"reset\":false"), std::string::npos);
+    EXPECT_NE(delta.find("\"removed\":[4]"), std::string::npos);
+    EXPECT_GT(tree.getStats().index_bytes, 0u);
+    
+    tree.setDeltaJournal(false);
+    EXPECT_EQ(tree.getStats().index_bytes, 0u);
+    EXPECT_EQ(tree.getStats().journal_bytes, 0u);
+    
+    STDSEngine engine;
+    EXPECT_FALSE(engine.getTree().hasDeltaJournal());
+}
+
+TEST(SequenceTreeTest, DeltaResetsForAnotherTree) {
+    SequenceTree old_tree(0.70);
+    for (int i = 0; i < 4; ++i) {
+        old_tree.insertSequence({1, 2, i}, true, false);
+    }
+    
+    // A replacement tree restarts its versions under a new epoch
+    SequenceTree tree(0.70);
+    tree.insertSequence({1, 2, 3}, true, false);
+    EXPECT_NE(tree.getEpoch(), old_tree.getEpoch());
+    EXPECT_LT(tree.getEpoch(), uint64_t(1) << 53);
+    
+    std::string epoch = "\"epoch\":" + std::to_string(tree.getEpoch()) + ",";
+    EXPECT_EQ(tree.getDelta(1).find(epoch), 1u);
+    EXPECT_EQ(tree.toJSON().find(epoch), 1u);
+    
+    // A version only the old tree reached gets a full snapshot, not an empty delta
+    std::string delta = tree.getDelta(old_tree.getVersion());
+    EXPECT_NE(delta.find("\"reset\":true"), std::string::npos);
+    EXPECT_NE(delta.find("\"nodes\":[[0,-1,"), std::string::npos);
+}
+
+TEST(PatternIndexTest, RanksConfidentPatternsIncrementally) {
+    SequenceTree tree(0.70);
+    PatternIndex index(PatternScore::SUPPORT);
+    tree.setPatternIndex(&index);
+    
+    for (int i = 0; i < 3; ++i) {
+        tree.insertSequence({1, 2, 3}, true, false);   // BUY, weight 3
+    }
+    tree.insertSequence({4, 5, 6}, false, true);       // SELL, weight 1
+    tree.insertSequence({4, 5, 6}, false, true);       // SELL, weight 2
+    tree.insertSequence({7, 8, 9}, false, false);      // NONE, not indexed
+    EXPECT_EQ(index.size(), 2u);
+    
+    std::vector<RankedPattern> top = index.top(10);
+    ASSERT_EQ(top.size(), 2u);
+    EXPECT_EQ(top[0].sequence, (std::vector<int>{1, 2, 3}));
+    EXPECT_TRUE(top[0].is_buy);
+    EXPECT_EQ(top[0].stats.buy_wins, 3u);
+    EXPECT_EQ(top[1].sequence, (std::vector<int>{4, 5, 6}));
+    EXPECT_FALSE(top[1].is_buy);
+    
+    ASSERT_EQ(index.top(10, PatternSide::SELL).size(), 1u);
+    EXPECT_EQ(index.top(1).size(), 1u);
+    
+    // Losing outcomes drop the BUY pattern once its ratio falls below the
+    // threshold (3/4 still passes, 3/5 does not)
+    tree.insertSequence({1, 2, 3}, false, false);
+    EXPECT_EQ(index.top(10, PatternSide::BUY).size(), 1u);
+    tree.insertSequence({1, 2, 3}, false, false);
+    EXPECT_TRUE(index.top(10, PatternSide::BUY).empty());
+    
+    // Removing the remaining SELL windows reclaims the nodes and empties the index
+    EXPECT_TRUE(tree.removeSequence({4, 5, 6}, false, true));
+    EXPECT_TRUE(tree.removeSequence({4, 5, 6}, false, true));
+    EXPECT_EQ(index.size(), 0u);
+}
+
+TEST(PatternIndexTest, WilsonScorePrefersSupport) {
+    SequenceTree tree(0.70);
+    PatternIndex index(PatternScore::WILSON);
+    tree.setPatternIndex(&index);
+    
+    tree.insertSequence({1, 1}, true, false);          // 1/1 wins
+    for (int i = 0; i < 20; ++i) {
+        tree.insertSequence({2, 2}, true, false);      // 19/20 wins
+    }
+    tree.insertSequence({2, 2}, false, false);
+    
+    std::vector<RankedPattern> top = index.top(2);
+    ASSERT_EQ(top.size(), 2u);
+    EXPECT_EQ(top[0].sequence, (std::vector<int>{2, 2}));
+    EXPECT_GT(top[0].score, top[1].score);
+}
+
+// Test FixedSequenceTree
+TEST(FixedSequenceTreeTest, PackKey) {
+    static constexpr int sequence[5] = {1, 2, 3, 4, 5};
+    static_assert(FixedSequenceTree<10, 5>::packKey(sequence) == 12345, "base-10 packing");
+    static_assert(FixedSequenceTree<16, 8>::keySpace() == (1ull << 32), "16^8 keys");
+    static_assert(FixedSequenceTree<10, 5>::shapeKey() != FixedSequenceTree<16, 8>::shapeKey(),
+                  "distinct shapes");
+    EXPECT_EQ((FixedSequenceTree<10, 5>::keySpace()), 100000u);
+    EXPECT_EQ(packShape(10, 5), (FixedSequenceTree<10, 5>::shapeKey()));
+    EXPECT_NE(packShape(5, 10), (FixedSequenceTree<10, 5>::shapeKey()));
+}
+
+TEST(FixedSequenceTreeTest, MatchesDynamicTree) {
+    SequenceTree dynamic_tree(0.70);
+    FixedSequenceTree<10, 5> fixed_tree(0.70);
+    
+    std::vector<std::vector<int> > sequences;
+    std::vector<bool> buys;
+    std::vector<bool> sells;
+    unsigned state = 12345;
+    for (int i = 0; i < 500; ++i) {
+        std::vector<int> sequence(5);
+        for (int& symbol : sequence) {
+            state = state * 1103515245u + 12345u;
+            symbol = (state >> 16) % 3 + 3;
+        }
+        bool buy = (state >> 8) % 3 == 0;
+        bool sell = !buy && (state >> 4) % 4 == 0;
+        dynamic_tree.insertSequence(sequence, buy, sell);
+        fixed_tree.insertSequence(sequence.data(), buy, sell);
+        sequences.push_back(sequence);
+        buys.push_back(buy);
+        sells.push_back(sell);
+    }
+    EXPECT_EQ(fixed_tree.getNodeCount(), dynamic_tree.getNodeCount());
+    
+    // Expire the first half from both trees
+    for (size_t i = 0; i < 250; ++i) {
+        EXPECT_TRUE(dynamic_tree.removeSequence(sequences[i], buys[i], sells[i]));
+        EXPECT_TRUE(fixed_tree.removeSequence(sequences[i].data(), buys[i], sells[i]));
+    }
+    EXPECT_EQ(fixed_tree.getNodeCount(), dynamic_tree.getNodeCount());
+    
+    for (const auto& sequence : sequences) {
+        const char* decision = fixed_tree.query(sequence.data());
+        const SequenceNode* node = dynamic_tree.findNode(sequence);
+        ASSERT_EQ(decision == nullptr, node == nullptr);
+        if (node) {
+            EXPECT_EQ(node->synthesis, decision);
+        }
+    }
+    
+    int out_of_range[5] = {1, 2, 3, 4, 10};
+    EXPECT_EQ(fixed_tree.query(out_of_range), nullptr);
+}
+
+// Test DataLoader
+TEST(DataLoaderTest, ParseTimestamp) {
+    EXPECT_EQ(DataLoader::parseTimestamp("1970-01-02"), 86400);
+    EXPECT_EQ(DataLoader::parseTimestamp("2024-01-01"), 1704067200);
+    EXPECT_EQ(DataLoader::parseTimestamp("2024-01-01 09:30:00"), 1704067200 + 34200);
+    EXPECT_EQ(DataLoader::parseTimestamp("2024-01-01T09:30"), 1704067200 + 34200);
+    EXPECT_EQ(DataLoader::parseTimestamp("1704067200"), 1704067200);
+    EXPECT_EQ(DataLoader::parseTimestamp("20240105"), 1704067200 + 4 * 86400);
+    EXPECT_EQ(DataLoader::parseTimestamp("\"20240101\""), 1704067200);
+    EXPECT_EQ(DataLoader::parseTimestamp("20241399"), 20241399);  // Not a date: epoch seconds
+    EXPECT_EQ(DataLoader::parseTimestamp("yesterday"), kNoTimestamp);
+}
+
+TEST(DataLoaderTest, MergesFilesInTimestampOrder) {
+    std::string later = "/tmp/stds_loader_b.csv";
+    std::string earlier = "/tmp/stds_loader_a.csv";
+    {
+        std::ofstream out(later.c_str());
+        out << "Date,Open,High,Low,Close,Volume\n"
+            << "2024-01-04,4,4,4,4,1\n"
+            << "2024-01-05,5,5,5,5,1\n"
+            << "2024-01-20,20,20,20,20,1\n";
+    }
+    {
+        std::ofstream out(earlier.c_str());
+        out << "Date,Open,High,Low,Close,Volume\r\n"
+            << "2024-01-01,1,1,1,1,1\r\n"
+            << "2024-01-02,2,2,2,2,1\r\n"
+            << "2024-01-03,3,3,3,3,1\r\n"
+            << "2024-01-04,9,9,9,9,1\r\n";
+    }
+    
+    std::vector<OHLCV> data;
+    std::vector<int64_t> timestamps;
+    LoadReport report;
+    DataLoader loader(2);
+    ASSERT_TRUE(loader.load({later, earlier}, data, timestamps, report));
+    
+    ASSERT_EQ(data.size(), 6u);
+    EXPECT_EQ(report.rows, 6u);
+    EXPECT_EQ(report.duplicates, 1u);
+    EXPECT_EQ(report.gaps, 1u);
+    EXPECT_DOUBLE_EQ(data[0].close, 1.0);
+    EXPECT_DOUBLE_EQ(data[3].close, 9.0);  // First bar seen for 2024-01-04 wins
+    EXPECT_DOUBLE_EQ(data[5].close, 20.0);
+    EXPECT_TRUE(std::is_sorted(timestamps.begin(), timestamps.end()));
+    
+    std::remove(later.c_str());
+    std::remove(earlier.c_str());
+}
+
+// Test Metrics
+TEST(MetricsTest, HistogramPercentiles) {
+    LatencyHistogram histogram;
+    for (uint64_t ns = 1; ns <= 1000; ++ns) {
+        histogram.record(ns * 1000);
+    }
+    
+    EXPECT_EQ(histogram.count(), 1000u);
+    EXPECT_NEAR(static_cast<double>(histogram.percentile(0.50)), 500000.0, 500000.0 * 0.125);
+    EXPECT_NEAR(static_cast<double>(histogram.percentile(0.99)), 990000.0, 990000.0 * 0.125);
+    EXPECT_GE(histogram.percentile(0.99), histogram.percentile(0.50));
+    
+    histogram.reset();
+    EXPECT_EQ(histogram.percentile(0.50), 0u);
+}
+
+// Test SpscRing
+TEST(SpscRingTest, PreservesOrderAcrossThreads) {
+    SpscRing<uint64_t> ring(100);
+    EXPECT_EQ(ring.capacity(), 128u);
+    
+    const uint64_t count = 200000;
+    std::thread producer([&ring, count]() {
+        for (uint64_t i = 0; i < count; ++i) {
+            while (!ring.tryPush(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    
+    uint64_t expected = 0;
+    uint64_t value = 0;
+    while (expected < count) {
+        if (ring.tryPop(value)) {
+            EXPECT_EQ(value, expected);
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    
+    EXPECT_FALSE(ring.tryPop(value));
+    for (size_t i = 0; i < ring.capacity(); ++i) {
+        EXPECT_TRUE(ring.tryPush(i));
+    }
+    EXPECT_FALSE(ring.tryPush(0));
+    EXPECT_EQ(ring.size(), ring.capacity());
+}
+
 // Test STDSEngine
 TEST(STDSEngineTest, LoadData) {
     STDSConfig config;
@@ -129,7 +599,266 @@ TEST(STDSEngineTest, LoadData) {
     });
 }
 
+TEST(STDSEngineTest, FailedLoadKeepsPreviousData) {
+    STDSEngine engine;
+    std::string path = writeSampleCSV("keep", 50);
+    ASSERT_TRUE(engine.loadData(path));
+    std::vector<double> edges = engine.getNormalizer().getBinEdges();
+    
+    EXPECT_FALSE(engine.loadData("/nonexistent/stds.csv"));
+    EXPECT_FALSE(engine.loadData(std::vector<std::string>{path, "/nonexistent/stds.csv"}));
+    EXPECT_EQ(engine.getHistory().size(), 50u);
+    EXPECT_EQ(engine.getTimestamps().size(), 50u);
+    EXPECT_EQ(engine.getNormalizer().getBinEdges(), edges);
+}
+
+TEST(STDSEngineTest, RollingWindowExpiresOldSequences) {
+    STDSConfig config;
+    config.sequence_length = 3;
+    config.lookahead_days = 2;
+    config.rolling_window = 20;
+    
+    STDSEngine engine(config);
+    ASSERT_TRUE(engine.loadData(writeSampleCSV("rolling", 60)));
+    engine.train();
+    
+    for (int i = 0; i < 40; ++i) {
+        OHLCV bar;
+        bar.open = bar.high = bar.low = bar.close = 100.0 + (i % 5);
+        bar.volume = 1000.0;
+        engine.processNewData(bar);
+        
+        // Every retained window is supported exactly once at depth one
+        const std::deque<LabeledWindow>& windows = engine.getRollingWindows();
+        ASSERT_FALSE(windows.empty());
+        uint64_t support = 0;
+        for (const auto& child : engine.getTree().getRoot()->children) {
+            support += child.second->weight;
+        }
+        EXPECT_EQ(support, windows.size());
+        EXPECT_LE(windows.size(), 20u);
+        EXPECT_GE(windows.front().data_index + 20, 60u + i + 1);
+    }
+}
+
+TEST(STDSEngineTest, RollingWindowRetrainReplacesWindows) {
+    STDSConfig config;
+    config.sequence_length = 3;
+    config.lookahead_days = 2;
+    config.rolling_window = 10;
+    
+    STDSEngine engine(config);
+    std::string path = writeSampleCSV("rolling_retrain", 60);
+    for (int round = 0; round < 3; ++round) {
+        ASSERT_TRUE(engine.loadData(path));
+        engine.train();
+        engine.train();
+        
+        uint64_t support = 0;
+        for (const auto& child : engine.getTree().getRoot()->children) {
+            support += child.second->weight;
+        }
+        ASSERT_FALSE(engine.getRollingWindows().empty());
+        EXPECT_EQ(support, engine.getRollingWindows().size());
+    }
+}
+
+TEST(STDSEngineTest, FixedTreeDispatch) {
+    STDSConfig config;
+    config.use_fixed_tree = true;
+    STDSEngine fixed_engine(config);
+    config.use_fixed_tree = false;
+    STDSEngine dynamic_engine(config);
+    config.use_fixed_tree = true;
+    config.sequence_length = 6;
+    STDSEngine unmatched_engine(config);
+    
+    EXPECT_TRUE(fixed_engine.usesFixedTree());
+    EXPECT_FALSE(dynamic_engine.usesFixedTree());
+    EXPECT_FALSE(unmatched_engine.usesFixedTree());
+    
+    std::string path = writeSampleCSV("dispatch", 300);
+    ASSERT_TRUE(fixed_engine.loadData(path));
+    ASSERT_TRUE(dynamic_engine.loadData(path));
+    fixed_engine.train();
+    dynamic_engine.train();
+    
+    for (int i = 0; i < 100; ++i) {
+        OHLCV bar;
+        bar.open = bar.high = bar.low = 100.0;
+        bar.close = 100.0 * (1.0 + ((i * 5) % 9 - 4) * 0.006);
+        bar.volume = 1000.0;
+        EXPECT_EQ(fixed_engine.processNewData(bar), dynamic_engine.processNewData(bar));
+    }
+}
+
+TEST(STDSEngineTest, PatternIndexIsOptIn) {
+    STDSConfig config;
+    STDSEngine plain_engine(config);
+    config.enable_pattern_index = true;
+    STDSEngine indexed_engine(config);
+    
+    std::string path = writeSampleCSV("patterns", 300);
+    ASSERT_TRUE(plain_engine.loadData(path));
+    ASSERT_TRUE(indexed_engine.loadData(path));
+    plain_engine.train();
+    indexed_engine.train();
+    
+    EXPECT_TRUE(plain_engine.getTopPatterns(10).empty());
+    EXPECT_FALSE(indexed_engine.getTopPatterns(10).empty());
+}
+
+TEST(STDSEngineTest, Float32HistoryKeepsDecisions) {
+    STDSConfig config;
+    STDSEngine wide_engine(config);
+    config.history_precision = ColumnPrecision::FLOAT32;
+    STDSEngine narrow_engine(config);
+    
+    std::string path = writeSampleCSV("precision", 300);
+    ASSERT_TRUE(wide_engine.loadData(path));
+    ASSERT_TRUE(narrow_engine.loadData(path));
+    wide_engine.train();
+    narrow_engine.train();
+    // Same tree apart from the epoch, which is drawn per instance
+    std::string wide_json = wide_engine.getTreeJSON();
+    std::string narrow_json = narrow_engine.getTreeJSON();
+    EXPECT_EQ(wide_json.substr(wide_json.find("\"version\"")),
+              narrow_json.substr(narrow_json.find("\"version\"")));
+    
+    const PriceHistory& wide = wide_engine.getHistory();
+    const PriceHistory& narrow = narrow_engine.getHistory();
+    ASSERT_EQ(wide.size(), narrow.size());
+    EXPECT_LT(narrow.memoryBytes(), wide.memoryBytes());
+    for (size_t i = 0; i < wide.size(); ++i) {
+        EXPECT_EQ(wide.close(i), narrow.close(i));
+        EXPECT_NEAR(wide.bar(i).high, narrow.bar(i).high, wide.bar(i).high * 1e-6);
+    }
+    
+    for (int i = 0; i < 50; ++i) {
+        OHLCV bar;
+        bar.open = bar.high = bar.low = 100.0;
+        bar.close = 100.0 * (1.0 + ((i * 5) % 9 - 4) * 0.006);
+        bar.volume = 1000.0;
+        EXPECT_EQ(wide_engine.processNewData(bar), narrow_engine.processNewData(bar));
+    }
+}
+
+TEST(STDSEngineTest, CrossValidationPurgesAndIsDeterministic) {
+    STDSConfig config;
+    config.use_fixed_tree = false;
+    STDSEngine engine(config);
+    ASSERT_TRUE(engine.loadData(writeSampleCSV("crossval", 400)));
+    
+    CrossValidationOptions options;
+    options.folds = 4;
+    options.num_threads = 1;
+    CrossValidationReport serial;
+    ASSERT_TRUE(engine.crossValidate(options, serial));
+    ASSERT_EQ(serial.folds.size(), 4u);
+    
+    // 10x5 has a specialization, but folds follow the engine's dynamic tree
+    EXPECT_FALSE(serial.fixed_tree);
+    
+    // Every window is either trained on, purged, or tested
+    size_t windows = 400 - 1 - config.sequence_length;
+    EXPECT_EQ(serial.test_windows, windows);
+    for (const FoldResult& fold : serial.folds) {
+        EXPECT_EQ(fold.train_windows + fold.purged_windows + fold.test_windows, windows);
+        EXPECT_GT(fold.purged_windows, 0u);
+        EXPECT_LE(fold.purged_windows,
+                  static_cast<size_t>(2 * (config.sequence_length + config.lookahead_days)));
+        EXPECT_GE(fold.coverage, 0.0);
+        EXPECT_LE(fold.coverage, 1.0);
+    }
+    
+    // The embargo only removes training windows after each test block
+    options.embargo = 10;
+    CrossValidationReport embargoed;
+    ASSERT_TRUE(engine.crossValidate(options, embargoed));
+    EXPECT_EQ(embargoed.folds[0].purged_windows, serial.folds[0].purged_windows + 10);
+    EXPECT_EQ(embargoed.folds[3].purged_windows, serial.folds[3].purged_windows);
+    
+    // Parallel folds and the fixed tree give the same answers
+    options.embargo = 0;
+    options.num_threads = 4;
+    config.use_fixed_tree = true;
+    STDSEngine fixed_engine(config);
+    ASSERT_TRUE(fixed_engine.loadData(writeSampleCSV("crossval", 400)));
+    CrossValidationReport parallel;
+    ASSERT_TRUE(fixed_engine.crossValidate(options, parallel));
+    EXPECT_TRUE(parallel.fixed_tree);
+    ASSERT_EQ(parallel.folds.size(), serial.folds.size());
+    for (size_t f = 0; f < serial.folds.size(); ++f) {
+        EXPECT_EQ(parallel.folds[f].correct, serial.folds[f].correct);
+        EXPECT_EQ(parallel.folds[f].buy_trades, serial.folds[f].buy_trades);
+        EXPECT_EQ(parallel.folds[f].sell_trades, serial.folds[f].sell_trades);
+    }
+    
+    options.folds = 1;
+    EXPECT_FALSE(engine.crossValidate(options, parallel));
+}
+
+TEST(STDSEngineTest, CrossValidationFollowsEngineLookup) {
+    STDSConfig config;
+    STDSEngine exact_engine(config);
+    config.approximate_max_distance = 3;
+    config.approximate_time_budget_us = 0;
+    config.rolling_window = 100;
+    STDSEngine approximate_engine(config);
+    
+    std::string path = writeSampleCSV("crossval_lookup", 400);
+    ASSERT_TRUE(exact_engine.loadData(path));
+    ASSERT_TRUE(approximate_engine.loadData(path));
+    
+    CrossValidationOptions options;
+    options.folds = 4;
+    CrossValidationReport exact;
+    CrossValidationReport approximate;
+    ASSERT_TRUE(exact_engine.crossValidate(options, exact));
+    ASSERT_TRUE(approximate_engine.crossValidate(options, approximate));
+    
+    // Windows missing from a fold's tree are answered by their nearest pattern
+    EXPECT_GT(approximate.trades, exact.trades);
+    EXPECT_FALSE(exact.rolling_window_ignored);
+    EXPECT_TRUE(approximate.rolling_window_ignored);
+}
+
+TEST(STDSEngineTest, MetricsRecordStagesAndTicks) {
+    STDSEngine engine;
+    ASSERT_TRUE(engine.loadData(writeSampleCSV("metrics", 200)));
+    engine.train();
+    
+    OHLCV bar;
+    bar.open = bar.high = bar.low = bar.close = 100.0;
+    bar.volume = 1000.0;
+    for (int i = 0; i < 10; ++i) {
+        engine.processNewData(bar);
+    }
+    
+    MetricsSnapshot metrics = engine.getMetrics();
+    EXPECT_EQ(metrics.tree_nodes, engine.getTree().getNodeCount());
+    EXPECT_GT(metrics.tree_bytes, 0u);
+    if (!metrics.compiled_in) {
+        return;
+    }
+    
+    EXPECT_EQ(metrics.stages[static_cast<int>(Stage::PARSE)].calls, 1u);
+    EXPECT_EQ(metrics.stages[static_cast<int>(Stage::FIT)].calls, 1u);
+    EXPECT_EQ(metrics.counters[static_cast<int>(Counter::SYNTHESES)],
+              metrics.counters[static_cast<int>(Counter::WINDOWS_INSERTED)]);
+    EXPECT_EQ(metrics.counters[static_cast<int>(Counter::ROWS_LOADED)], 200u);
+    EXPECT_EQ(metrics.counters[static_cast<int>(Counter::TICKS)], 10u);
+    EXPECT_EQ(metrics.tick_count, 10u);
+    EXPECT_GE(metrics.tick_p99_ns, metrics.tick_p50_ns);
+    
+    // Switched off at run time, nothing more is recorded
+    engine.setMetricsEnabled(false);
+    engine.processNewData(bar);
+    EXPECT_EQ(engine.getMetrics().tick_count, 10u);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
+    ::testing::AddGlobalTestEnvironment(new SampleFileCleanup);
     return RUN_ALL_TESTS();
 }
@@ -46,6 +46,80 @@ describe('STDS Bindings Tests', () => {
     expect(tree).toHaveProperty('root');
   });
 
+  test('Tree delta tracks versions', () => {
+    expect(JSON.parse(engine.getTreeDelta(engine.getTreeVersion())).reset).toBe(true);
+
+    engine = new STDSEngine({ enableDeltaFeed: true });
+    const dataPath = path.join(__dirname, '../data/sample.csv');
+    engine.loadData(dataPath);
+    engine.train();
+
+    const version = engine.getTreeVersion();
+    expect(version).toBeGreaterThan(0);
+
+    const full = JSON.parse(engine.getTreeDelta(0));
+    expect(full.epoch).toBe(engine.getTreeEpoch());
+    expect(full.version).toBe(version);
+    expect(full.fields[0]).toBe('id');
+    expect(full.nodes[0][0]).toBe(0);
+    expect(full.nodes.length).toBeGreaterThan(1);
+
+    const empty = JSON.parse(engine.getTreeDelta(version));
+    expect(empty.nodes).toEqual([]);
+    expect(empty.removed).toEqual([]);
+  });
+
+  test('Tree stats', () => {
+    const dataPath = path.join(__dirname, '../data/sample.csv');
+    engine.loadData(dataPath);
+    engine.train();
+
+    const stats = engine.getTreeStats();
+    expect(stats.nodes).toBeGreaterThan(1);
+    expect(stats.nodesPerDepth[0]).toBe(1);
+    expect(stats.maxDepth).toBe(5);
+    expect(stats.bytes.total).toBeGreaterThanOrEqual(stats.bytes.nodes + stats.bytes.childMaps);
+
+    const { BUY, SELL, HOLD, NONE } = stats.decisions;
+    expect(BUY + SELL + HOLD + NONE).toBe(stats.nodes - 1);
+  });
+
+  test('Top patterns', () => {
+    expect(engine.getTopPatterns(5)).toEqual([]);
+
+    engine = new STDSEngine({ enablePatternIndex: true });
+    const dataPath = path.join(__dirname, '../data/sample.csv');
+    engine.loadData(dataPath);
+    engine.train();
+
+    const patterns = engine.getTopPatterns(5);
+    expect(patterns.length).toBeLessThanOrEqual(5);
+    patterns.forEach((pattern, i) => {
+      expect(['BUY', 'SELL']).toContain(pattern.decision);
+      expect(pattern.sequence.length).toBe(5);
+      if (i > 0) {
+        expect(pattern.score).toBeLessThanOrEqual(patterns[i - 1].score);
+      }
+    });
+    engine.getTopPatterns(5, 'SELL').forEach((pattern) => {
+      expect(pattern.decision).toBe('SELL');
+    });
+  });
+
+  test('Cross-validation', () => {
+    const dataPath = path.join(__dirname, '../data/sample.csv');
+    engine.loadData(dataPath);
+
+    const report = engine.crossValidate({ folds: 3, embargo: 2 });
+    expect(report.folds.length).toBe(3);
+    report.folds.forEach((fold) => {
+      expect(fold.coverage).toBeGreaterThanOrEqual(0);
+      expect(fold.coverage).toBeLessThanOrEqual(1);
+      expect(fold.correct).toBeLessThanOrEqual(fold.buyTrades + fold.sellTrades);
+    });
+    expect(() => engine.crossValidate({ folds: 1 })).toThrow();
+  });
+
   test('Process new data', () => {
     const dataPath = path.join(__dirname, '../data/sample.csv');
     engine.loadData(dataPath);
@@ -65,6 +139,31 @@ describe('STDS Bindings Tests', () => {
     expect(['BUY', 'SELL', 'HOLD', 'NONE']).toContain(decision);
   });
 
+  test('Engine thread processes queued ticks in order', (done) => {
+    const dataPath = path.join(__dirname, '../data/sample.csv');
+    engine.loadData(dataPath);
+    engine.train();
+
+    const received = [];
+    engine.startEngineThread((batch) => {
+      batch.forEach((event) => {
+        expect(['BUY', 'SELL', 'HOLD', 'NONE']).toContain(event.decision);
+        expect(event.latencyNs).toBeGreaterThanOrEqual(0);
+        received.push(event.seq);
+      });
+      if (received.length === 20) {
+        engine.stopEngineThread();
+        expect(received).toEqual([...Array(20).keys()]);
+        done();
+      }
+    }, { queueSize: 64, maxBatch: 8 });
+
+    for (let i = 0; i < 20; ++i) {
+      const close = 120.0 + (i % 5);
+      expect(engine.enqueueTick({ open: close, high: close, low: close, close, volume: 1000 })).toBe(i);
+    }
+  });
+
   test('Node callback', (done) => {
     let callbackCalled = false;
     